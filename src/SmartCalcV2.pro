@@ -13,14 +13,26 @@ INCLUDEPATH += plot
 SOURCES += \
     main.cc \
     model/model.cc \
+    model/decimal.cc \
+    model/interval.cc \
+    model/jit.cc \
+    model/parallel.cc \
+    model/parser.cc \
     view/mainwindow.cc \
     plot/qcustomplot.cc \
     view/plotgraph.cc
 
 HEADERS += \
     model/model.h \
+    model/decimal.h \
+    model/interval.h \
+    model/parallel.h \
+    model/parser.h \
+    model/simd.h \
+    model/static_expr.h \
     view/mainwindow.h \
     controller/controller.h \
+    controller/lru_cache.h \
     plot/qcustomplot.h \
     view/plotgraph.h
 
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "controller/controller.h"
+#include "model/model.h"
+#include "model/parallel.h"
+#include "tests/alloc_counter.h"
+
+// Every benchmark reports time per op (google-benchmark's own columns),
+// heap allocations per op and, where meaningful, items per second. Run with
+// --benchmark_out=FILE --benchmark_out_format=json to keep results.
+
+constexpr const char* kExpressions[] = {
+    "x",
+    "sin(x*12.5)-(cos(3.14)^10+tan(x))",
+    "((x+1)*(x-2)-(x*3)/(x+4))^2%7+sqrt(x*x)+hypot(x, 3)",
+};
+
+class AllocationCounter {
+ public:
+  explicit AllocationCounter(benchmark::State& state)
+      : state_(state), start_(allocations.load()) {}
+
+  ~AllocationCounter() {
+    state_.counters["allocs/op"] =
+        benchmark::Counter(double(allocations.load() - start_),
+                           benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  benchmark::State& state_;
+  std::size_t start_;
+};
+
+static void BM_LexerCollect(benchmark::State& state) {
+  auto expr = kExpressions[state.range(0)];
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    s21::Lexer lexer(expr);
+    benchmark::DoNotOptimize(lexer.Collect());
+  }
+}
+BENCHMARK(BM_LexerCollect)->DenseRange(0, 2);
+
+// Parse_ is private; Compile is parse plus DAG building and codegen.
+static void BM_Compile(benchmark::State& state) {
+  auto expr = kExpressions[state.range(0)];
+  s21::SmartCalc calc;
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) benchmark::DoNotOptimize(calc.Compile(expr));
+}
+BENCHMARK(BM_Compile)->DenseRange(0, 2);
+
+static void BM_SmartCalcEvaluate(benchmark::State& state) {
+  auto expr = kExpressions[state.range(0)];
+  s21::SmartCalc calc;
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) benchmark::DoNotOptimize(calc.Evaluate(expr, 1.5));
+}
+BENCHMARK(BM_SmartCalcEvaluate)->DenseRange(0, 2);
+
+static void BM_CompiledEvaluate(benchmark::State& state) {
+  s21::SmartCalc calc;
+  auto tier = static_cast<s21::SmartCalc::Tier>(state.range(1));
+  auto expr = calc.Compile(kExpressions[state.range(0)], tier);
+  double x = 1.5;
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(expr.Evaluate(x));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CompiledEvaluate)->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+static void BM_CreditAnnual(benchmark::State& state) {
+  s21::CreditCalc credit;
+  s21::CreditCalc::Term term{1e6, s21::CreditCalc::TermType::Years, 30, 7};
+  AllocationCounter allocs(state);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        credit.Evaluate(term, s21::CreditCalc::CreditType::Annual));
+}
+BENCHMARK(BM_CreditAnnual);
+
+static void BM_CreditDiff(benchmark::State& state) {
+  s21::CreditCalc credit;
+  s21::CreditCalc::Term term{1e6, s21::CreditCalc::TermType::Years, 30, 7};
+  AllocationCounter allocs(state);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        credit.Evaluate(term, s21::CreditCalc::CreditType::Diff));
+}
+BENCHMARK(BM_CreditDiff);
+
+// The PlotGraph loop: tabulate [-xmax, xmax) in steps of 0.1 through the
+// Controller, one value at a time or as one batch.
+static auto PlotRange(double xmax) {
+  std::vector<double> xs;
+  for (double x = -xmax; x < xmax; x += 0.1) xs.push_back(x);
+  return xs;
+}
+
+static void BM_PlotSamplingEval(benchmark::State& state) {
+  s21::Controller ctrl(std::make_unique<s21::SmartCalc>(),
+                       std::make_unique<s21::CreditCalc>());
+  auto xs = PlotRange(double(state.range(0)));
+  std::vector<double> ys(xs.size());
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < xs.size(); ++i)
+      ys[i] = ctrl.Eval(kExpressions[1], xs[i]);
+    benchmark::DoNotOptimize(ys.data());
+  }
+  state.SetItemsProcessed(state.iterations() * xs.size());
+}
+BENCHMARK(BM_PlotSamplingEval)->Arg(100)->Arg(10000);
+
+static void BM_PlotSamplingBatch(benchmark::State& state) {
+  s21::Controller ctrl(std::make_unique<s21::SmartCalc>(),
+                       std::make_unique<s21::CreditCalc>());
+  auto xs = PlotRange(double(state.range(0)));
+  std::vector<double> ys(xs.size());
+  AllocationCounter allocs(state);
+
+  for (auto _ : state) {
+    ctrl.EvalBatch(kExpressions[1], xs.data(), ys.data(), xs.size());
+    benchmark::DoNotOptimize(ys.data());
+  }
+  state.SetItemsProcessed(state.iterations() * xs.size());
+}
+BENCHMARK(BM_PlotSamplingBatch)->Arg(100)->Arg(10000);
+
+static void BM_ParallelBatch(benchmark::State& state) {
+  s21::SmartCalc calc;
+  s21::ParallelExecutor executor;
+  auto expr = calc.Compile(kExpressions[1]);
+  std::vector<double> xs(std::size_t(state.range(0))), ys(xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = 1e-6 * i;
+  AllocationCounter allocs(state);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        executor.Run(expr, xs.data(), ys.data(), xs.size()));
+  state.SetItemsProcessed(state.iterations() * xs.size());
+}
+BENCHMARK(BM_ParallelBatch)->Arg(1 << 22)->UseRealTime();
+
+BENCHMARK_MAIN();
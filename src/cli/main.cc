@@ -0,0 +1,156 @@
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "controller/controller.h"
+#include "io/bulk.h"
+#include "io/columns.h"
+#include "model/decimal.h"
+#include "model/model.h"
+
+// Reads one expression per line, optionally followed by ",x" (the last
+// comma outside parentheses), and writes one result per line. Failed lines
+// print "error: ..." so output stays aligned with input. With --bulk the
+// input file is mapped and evaluated by all cores into fixed-width records;
+// --columns evaluates an expression over a binary column file.
+
+constexpr std::size_t kOutputBuffer = 1 << 16;
+constexpr std::size_t kCacheCapacity = 1024;
+
+class Output {
+ public:
+  Output() { buffer_.reserve(kOutputBuffer); }
+  ~Output() { Flush(); }
+
+ public:
+  void Write(std::string_view text) {
+    if (buffer_.size() + text.size() > kOutputBuffer) Flush();
+    buffer_.insert(buffer_.end(), text.begin(), text.end());
+  }
+
+  void Write(double value) {
+    char digits[32];
+    auto [end, ec] =
+        s21::decimal::ToChars(digits, digits + sizeof(digits), value);
+    Write(std::string_view(digits, ec == std::errc() ? end - digits : 0));
+  }
+
+  void Flush() {
+    std::fwrite(buffer_.data(), 1, buffer_.size(), stdout);
+    buffer_.clear();
+  }
+
+ private:
+  std::vector<char> buffer_;
+};
+
+static auto EvaluateLine(s21::Controller& ctrl, std::string_view text)
+    -> double {
+  auto line = s21::io::ParseLine(text);
+  return ctrl.Eval(line.expr, line.x);
+}
+
+static auto Process(s21::Controller& ctrl, std::istream& in, Output& out)
+    -> std::size_t {
+  std::string line;
+  std::size_t errors = 0;
+
+  while (std::getline(in, line)) {
+    if (line.find_first_not_of(" \t\r") != line.npos) {
+      try {
+        out.Write(EvaluateLine(ctrl, line));
+      } catch (const std::exception& e) {
+        out.Write("error: ");
+        out.Write(e.what());
+        ++errors;
+      }
+    }
+
+    out.Write("\n");
+  }
+
+  return errors;
+}
+
+// A missing thread count means one thread per core.
+static auto Bulk(const std::string& input, const std::string& output,
+                 std::string_view threads) -> int {
+  try {
+    std::size_t count = 0;
+    auto end = threads.data() + threads.size();
+    auto [ptr, ec] = std::from_chars(threads.data(), end, count);
+
+    if (!threads.empty() && (ec != std::errc() || ptr != end))
+      throw std::invalid_argument("invalid thread count '" +
+                                  std::string(threads) + "'");
+
+    auto stats = s21::io::BulkEvaluate(s21::SmartCalc(), input, output,
+                                       count);
+    std::cerr << stats.lines << " lines, " << stats.errors << " errors\n";
+    return stats.errors ? 1 : 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 2;
+  }
+}
+
+static auto Columns(const char* expr, const std::string& input,
+                    const std::string& output) -> int {
+  try {
+    auto rows = s21::io::EvaluateColumns(s21::SmartCalc(), expr, input, output);
+    std::cerr << rows << " rows\n";
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 2;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  std::ios::sync_with_stdio(false);
+
+  if (argc >= 4 && std::strcmp(argv[1], "--bulk") == 0)
+    return Bulk(argv[2], argv[3], argc > 4 ? argv[4] : "");
+  if (argc == 5 && std::strcmp(argv[1], "--columns") == 0)
+    return Columns(argv[2], argv[3], argv[4]);
+
+  s21::Controller ctrl(std::make_unique<s21::SmartCalc>(),
+                       std::make_unique<s21::CreditCalc>(), kCacheCapacity);
+  Output out;
+  std::size_t errors = 0;
+
+  if (argc < 2) errors += Process(ctrl, std::cin, out);
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-h") == 0 ||
+        std::strcmp(argv[i], "--help") == 0) {
+      std::cerr << "usage: " << argv[0] << " [FILE | -]...\n"
+                << "       " << argv[0]
+                << " --bulk INPUT OUTPUT [THREADS]\n"
+                << "       " << argv[0] << " --columns EXPR INPUT OUTPUT\n";
+      return 0;
+    }
+
+    if (std::strcmp(argv[i], "-") == 0) {
+      errors += Process(ctrl, std::cin, out);
+      continue;
+    }
+
+    std::ifstream file(argv[i]);
+    if (!file) {
+      out.Flush();
+      std::cerr << argv[0] << ": cannot open '" << argv[i] << "'\n";
+      return 2;
+    }
+    errors += Process(ctrl, file, out);
+  }
+
+  return errors ? 1 : 0;
+}
@@ -1,11 +1,19 @@
 #ifndef SMART_CALC_V2_CONTROLLER_CONTROLLER_H_
 #define SMART_CALC_V2_CONTROLLER_CONTROLLER_H_
 
+#include <memory>
+#include <mutex>
 #include <string_view>
 
+#include "controller/lru_cache.h"
 #include "model/model.h"
+#include "model/parallel.h"
 
 namespace s21 {
+// Every member may be called concurrently except the constructors and
+// assignment. The cache is guarded by a mutex held only to look up and to
+// insert; compiling on a miss and evaluation run outside the lock, the
+// latter on a shared, immutable program.
 class Controller {
  private:
   using Term = CreditCalc::Term;
@@ -13,31 +21,97 @@ class Controller {
   using Result = CreditCalc::Result;
   using ScPtr = std::unique_ptr<SmartCalc>;
   using CcPtr = std::unique_ptr<CreditCalc>;
+  using ProgramPtr = std::shared_ptr<const CompiledExpression>;
+  using Cache = LruCache<ProgramPtr>;
+
+ public:
+  using CacheStats = Cache::Stats;
+  using ParallelReport = ParallelExecutor::Report;
+
+  static constexpr std::size_t kDefaultCacheCapacity = 512;
 
  public:
   Controller() = default;
-  Controller(ScPtr calc_model, CcPtr credit_model)
-      : calc_(std::move(calc_model)), credit_(std::move(credit_model)) {}
+  Controller(ScPtr calc_model, CcPtr credit_model,
+             std::size_t cache_capacity = kDefaultCacheCapacity)
+      : calc_(std::move(calc_model)),
+        credit_(std::move(credit_model)),
+        cache_(cache_capacity) {}
   Controller(const Controller&) = delete;
-  Controller(Controller&& other) = default;
+  Controller(Controller&& other) = delete;
   ~Controller() = default;
 
  public:
   auto operator=(const Controller&) -> Controller& = delete;
-  auto operator=(Controller&& rhs) -> Controller& = default;
+  auto operator=(Controller&& rhs) -> Controller& = delete;
 
  public:
   inline auto Eval(std::string_view expr, double x) -> double {
-    return calc_->Evaluate(expr, x);
+    return Compiled_(expr)->Evaluate(x);
+  }
+
+  inline void EvalBatch(std::string_view expr, const double* xs, double* out,
+                        std::size_t n) {
+    Compiled_(expr)->EvaluateBatch(xs, out, n);
+  }
+
+  // Spreads large arrays over a thread pool started on first use.
+  inline auto EvalParallel(std::string_view expr, const double* xs,
+                           double* out, std::size_t n) -> ParallelReport {
+    auto program = Compiled_(expr);
+    return Executor_().Run(*program, xs, out, n);
+  }
+
+  inline auto Compile(std::string_view expr) -> CompiledExpression {
+    return *Compiled_(expr);
+  }
+
+  inline void SetCacheCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.SetCapacity(capacity);
+  }
+
+  inline auto GetCacheStats() const -> CacheStats {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.stats();
   }
 
   inline auto CalcCredit(const Term& term, CreditType type) -> Result {
     return credit_->Evaluate(term, type);
   }
 
+ private:
+  // Compiled programs are cached by expression text. Registering a function
+  // after an expression was cached does not affect the cached program. Two
+  // threads missing on the same text both compile; the first to insert
+  // wins.
+  inline auto Compiled_(std::string_view expr) -> ProgramPtr {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (auto program = cache_.Find(expr)) return *program;
+    }
+
+    auto program =
+        std::make_shared<const CompiledExpression>(calc_->Compile(expr));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.Insert(expr, std::move(program));
+  }
+
+  inline auto Executor_() -> ParallelExecutor& {
+    std::call_once(executor_once_, [this] {
+      executor_ = std::make_unique<ParallelExecutor>();
+    });
+    return *executor_;
+  }
+
  private:
   ScPtr calc_;
   CcPtr credit_;
+  Cache cache_{kDefaultCacheCapacity};
+  mutable std::mutex mutex_;
+  std::unique_ptr<ParallelExecutor> executor_;
+  std::once_flag executor_once_;
 };
 }  // namespace s21
 
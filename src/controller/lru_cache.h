@@ -0,0 +1,113 @@
+#ifndef SMART_CALC_V2_CONTROLLER_LRU_CACHE_H_
+#define SMART_CALC_V2_CONTROLLER_LRU_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace s21 {
+// Bounded map from strings to values that evicts the least recently used
+// entry. The index keys are views into the list nodes, so a hit never
+// allocates. A capacity of zero disables caching.
+template <typename Value>
+class LruCache {
+ public:
+  struct Stats {
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t evictions{0};
+  };
+
+ public:
+  explicit LruCache(std::size_t capacity) : capacity_(capacity) {}
+  LruCache(const LruCache&) = delete;
+  LruCache(LruCache&&) = default;
+  ~LruCache() = default;
+
+ public:
+  auto operator=(const LruCache&) -> LruCache& = delete;
+  auto operator=(LruCache&&) -> LruCache& = default;
+
+ public:
+  // Returns the cached value for key, or stores make() under it. If make
+  // throws, nothing is cached.
+  template <typename Make>
+  auto GetOrInsert(std::string_view key, Make make) -> const Value& {
+    if (auto value = Find(key)) return *value;
+    return Insert(key, make());
+  }
+
+  // Counts a hit or a miss. A hit becomes the most recently used entry.
+  auto Find(std::string_view key) -> const Value* {
+    auto it = index_.find(key);
+
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->second;
+  }
+
+  // Stores value under key unless the key is already cached, so a caller
+  // that made its value between Find and Insert gets the first one stored.
+  auto Insert(std::string_view key, Value value) -> const Value& {
+    if (auto it = index_.find(key); it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+
+    if (capacity_ == 0) {
+      scratch_ = std::move(value);
+      return scratch_;
+    }
+
+    entries_.emplace_front(std::string(key), std::move(value));
+    index_.emplace(entries_.front().first, entries_.begin());
+    Shrink_();
+
+    return entries_.front().second;
+  }
+
+  void SetCapacity(std::size_t capacity) {
+    capacity_ = capacity;
+    Shrink_();
+  }
+
+  void Clear() {
+    index_.clear();
+    entries_.clear();
+  }
+
+  auto capacity() const { return capacity_; }
+  auto size() const { return entries_.size(); }
+  auto stats() const -> const Stats& { return stats_; }
+
+ private:
+  void Shrink_() {
+    while (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+      ++stats_.evictions;
+    }
+  }
+
+ private:
+  using Entry = std::pair<std::string, Value>;
+
+  std::size_t capacity_;
+  std::list<Entry> entries_;
+  std::unordered_map<std::string_view,
+                     typename std::list<Entry>::iterator>
+      index_;
+  Value scratch_{};
+  Stats stats_;
+};
+}  // namespace s21
+
+#endif  // SMART_CALC_V2_CONTROLLER_LRU_CACHE_H_
@@ -0,0 +1,177 @@
+#include "bulk.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "controller/lru_cache.h"
+#include "mapped_file.h"
+#include "model/decimal.h"
+
+constexpr std::size_t kCacheCapacity = 1024;
+
+struct Range {
+  const char* begin;
+  const char* end;
+  std::size_t first_line{0};
+  std::size_t errors{0};
+};
+
+static auto Trim(std::string_view text) -> std::string_view {
+  auto first = text.find_first_not_of(" \t\r");
+  if (first == text.npos) return {};
+  auto last = text.find_last_not_of(" \t\r");
+  return text.substr(first, last - first + 1);
+}
+
+static auto CountLines(const char* begin, const char* end) -> std::size_t {
+  std::size_t lines = 0;
+  for (auto it = begin; it != end; ++lines) {
+    auto nl = static_cast<const char*>(std::memchr(it, '\n', end - it));
+    it = nl ? nl + 1 : end;
+  }
+  return lines;
+}
+
+// Cut points are moved forward past the next newline, so no line straddles
+// two ranges.
+static auto Partition(std::string_view text, std::size_t parts)
+    -> std::vector<Range> {
+  std::vector<Range> ranges;
+  auto begin = text.data();
+  auto end = text.data() + text.size();
+
+  for (std::size_t i = 1; i <= parts && begin != end; ++i) {
+    auto cut = i == parts ? end : text.data() + text.size() * i / parts;
+    if (cut < begin) cut = begin;
+    if (cut != end) {
+      auto nl = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+      cut = nl ? nl + 1 : end;
+    }
+    if (cut != begin) ranges.push_back({begin, cut});
+    begin = cut;
+  }
+
+  return ranges;
+}
+
+static void WriteRecord(char* record, std::string_view text) {
+  auto len = std::min(text.size(), s21::io::kRecordWidth - 1);
+  std::memcpy(record, text.data(), len);
+  std::memset(record + len, ' ', s21::io::kRecordWidth - 1 - len);
+  record[s21::io::kRecordWidth - 1] = '\n';
+}
+
+static void EvaluateRange(const s21::SmartCalc& calc, Range& range,
+                          char* out) {
+  s21::LruCache<s21::CompiledExpression> cache(kCacheCapacity);
+  auto record = out + range.first_line * s21::io::kRecordWidth;
+
+  for (auto it = range.begin; it != range.end;
+       record += s21::io::kRecordWidth) {
+    auto nl = static_cast<const char*>(
+        std::memchr(it, '\n', range.end - it));
+    auto eol = nl ? nl : range.end;
+    auto text = Trim({it, std::size_t(eol - it)});
+    it = nl ? nl + 1 : range.end;
+
+    if (text.empty()) {
+      WriteRecord(record, "");
+      continue;
+    }
+
+    try {
+      auto line = s21::io::ParseLine(text);
+      auto& expr =
+          cache.GetOrInsert(line.expr, [&] { return calc.Compile(line.expr); });
+
+      char digits[s21::io::kRecordWidth];
+      auto value = expr.Evaluate(line.x);
+      auto [end, ec] =
+          s21::decimal::ToChars(digits, digits + sizeof(digits), value);
+      WriteRecord(record, {digits, std::size_t(end - digits)});
+    } catch (const std::exception& e) {
+      WriteRecord(record, std::string("error: ") + e.what());
+      ++range.errors;
+    }
+  }
+}
+
+auto s21::io::ParseLine(std::string_view text) -> Line {
+  std::size_t comma = text.npos;
+  int depth = 0;
+
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '(')
+      ++depth;
+    else if (text[i] == ')')
+      --depth;
+    else if (text[i] == ',' && depth == 0)
+      comma = i;
+  }
+
+  Line line{Trim(text)};
+  if (comma == text.npos) return line;
+
+  auto arg = Trim(text.substr(comma + 1));
+  auto [end, ec] =
+      s21::decimal::FromChars(arg.data(), arg.data() + arg.size(), line.x);
+  if (ec != std::errc() || end != arg.data() + arg.size())
+    throw std::invalid_argument("invalid value for x");
+
+  line.expr = Trim(text.substr(0, comma));
+  return line;
+}
+
+auto s21::io::BulkEvaluate(const SmartCalc& calc, const std::string& input,
+                           const std::string& output, std::size_t threads)
+    -> BulkStats {
+  if (threads > kMaxThreads)
+    throw std::invalid_argument("at most " + std::to_string(kMaxThreads) +
+                                " threads");
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  if (MappedFile::SameFile(input, output))
+    throw std::invalid_argument("output '" + output + "' is the input file");
+
+  auto in = MappedFile::OpenRead(input);
+  auto ranges = Partition(in.view(), threads);
+
+  auto for_each_range = [&ranges](auto fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(ranges.size());
+
+    try {
+      for (auto& range : ranges) workers.emplace_back(fn, std::ref(range));
+    } catch (const std::system_error& e) {
+      for (auto& worker : workers) worker.join();
+      throw std::runtime_error(std::string("cannot start thread: ") +
+                               e.what());
+    }
+
+    for (auto& worker : workers) worker.join();
+  };
+
+  // Line counts are stashed in first_line, then turned into offsets.
+  for_each_range([](Range& range) {
+    range.first_line = CountLines(range.begin, range.end);
+  });
+
+  BulkStats stats;
+  for (auto& range : ranges) {
+    auto lines = range.first_line;
+    range.first_line = stats.lines;
+    stats.lines += lines;
+  }
+
+  auto out = MappedFile::Create(output, stats.lines * kRecordWidth);
+  for_each_range(
+      [&](Range& range) { EvaluateRange(calc, range, out.data()); });
+
+  for (auto& range : ranges) stats.errors += range.errors;
+  return stats;
+}
@@ -0,0 +1,42 @@
+#ifndef SMART_CALC_V2_IO_BULK_H_
+#define SMART_CALC_V2_IO_BULK_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "model/model.h"
+
+namespace s21::io {
+// Every output record is this many bytes: the result (or "error: ..."
+// truncated to fit), space padded, then '\n'. Fixed records let each
+// thread write its lines at offsets known before evaluation starts.
+constexpr std::size_t kRecordWidth = 32;
+
+// Each range gets a thread of its own, so the count is capped.
+constexpr std::size_t kMaxThreads = 256;
+
+struct Line {
+  std::string_view expr;
+  double x{0};
+};
+
+struct BulkStats {
+  std::size_t lines{0};
+  std::size_t errors{0};
+};
+
+// Splits "expr" or "expr,x" at the last comma outside parentheses and
+// trims both parts. Throws std::invalid_argument for a malformed x.
+auto ParseLine(std::string_view) -> Line;
+
+// Maps input, splits it at newlines into one range per thread and writes
+// one record per input line into a mapping of output sized up front.
+// Throws std::invalid_argument if output is the input file or threads
+// exceeds kMaxThreads, and std::runtime_error if a thread cannot start.
+auto BulkEvaluate(const SmartCalc&, const std::string& input,
+                  const std::string& output, std::size_t threads = 0)
+    -> BulkStats;
+}  // namespace s21::io
+
+#endif  // SMART_CALC_V2_IO_BULK_H_
@@ -0,0 +1,130 @@
+#include "columns.h"
+
+#include <cstring>
+#include <stdexcept>
+
+constexpr char kMagic[8] = {'S', 'C', 'A', 'L', 'C', 'C', 'O', 'L'};
+constexpr std::size_t kHeaderSize = 32;
+
+static auto IsLittleEndian() -> bool {
+  std::uint16_t probe = 1;
+  unsigned char first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+static auto AlignUp(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+static auto Load(const char* data) -> T {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename T>
+static void Store(char* data, T value) {
+  std::memcpy(data, &value, sizeof(T));
+}
+
+static void CheckHost() {
+  if (!IsLittleEndian())
+    throw std::runtime_error("column files need a little-endian host");
+}
+
+auto s21::io::ColumnFile::Open(const std::string& path) -> ColumnFile {
+  CheckHost();
+
+  ColumnFile file;
+  file.file_ = MappedFile::OpenRead(path);
+  auto data = file.file_.data();
+  auto size = file.file_.size();
+
+  if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+      Load<std::uint32_t>(data + 8) != kVersion)
+    throw std::runtime_error("'" + path + "' is not a column file");
+
+  auto columns = std::size_t(Load<std::uint32_t>(data + 12));
+  file.rows_ = std::size_t(Load<std::uint64_t>(data + 16));
+  file.stride_ = std::size_t(Load<std::uint64_t>(data + 24));
+  file.data_ = AlignUp(kHeaderSize + columns * kNameSize, kAlignment);
+
+  // Sizes are checked by division so corrupt counts cannot overflow.
+  bool valid = file.data_ <= size && file.stride_ % kAlignment == 0 &&
+               file.stride_ / sizeof(double) >= file.rows_ &&
+               (columns == 0 ||
+                file.stride_ <= (size - file.data_) / columns);
+  if (!valid) throw std::runtime_error("'" + path + "' is truncated");
+
+  for (std::size_t i = 0; i < columns; ++i) {
+    auto name = data + kHeaderSize + i * kNameSize;
+    file.names_.emplace_back(name, strnlen(name, kNameSize));
+  }
+
+  return file;
+}
+
+auto s21::io::ColumnFile::Create(const std::string& path,
+                                 const std::vector<std::string>& names,
+                                 std::size_t rows) -> ColumnFile {
+  CheckHost();
+
+  for (auto& name : names)
+    if (name.empty() || name.size() >= kNameSize)
+      throw std::invalid_argument("invalid column name '" + name + "'");
+
+  ColumnFile file;
+  file.names_ = names;
+  file.rows_ = rows;
+  file.stride_ = AlignUp(rows * sizeof(double), kAlignment);
+  file.data_ = AlignUp(kHeaderSize + names.size() * kNameSize, kAlignment);
+  file.writable_ = true;
+  file.file_ =
+      MappedFile::Create(path, file.data_ + file.stride_ * names.size());
+
+  auto data = file.file_.data();
+  std::memcpy(data, kMagic, sizeof(kMagic));
+  Store(data + 8, kVersion);
+  Store(data + 12, std::uint32_t(names.size()));
+  Store(data + 16, std::uint64_t(rows));
+  Store(data + 24, std::uint64_t(file.stride_));
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+    std::memcpy(data + kHeaderSize + i * kNameSize, names[i].data(),
+                names[i].size());
+
+  return file;
+}
+
+auto s21::io::ColumnFile::column(std::size_t i) const -> const double* {
+  auto ptr = file_.data() + data_ + stride_ * i;
+  return reinterpret_cast<const double*>(ptr);
+}
+
+auto s21::io::ColumnFile::column(std::size_t i) -> double* {
+  if (!writable_) throw std::logic_error("column file is read-only");
+  return reinterpret_cast<double*>(file_.data() + data_ + stride_ * i);
+}
+
+auto s21::io::EvaluateColumns(const SmartCalc& calc, std::string_view expr,
+                              const std::string& input,
+                              const std::string& output,
+                              const std::string& result) -> std::size_t {
+  if (MappedFile::SameFile(input, output))
+    throw std::invalid_argument("output '" + output + "' is the input file");
+
+  const auto in = ColumnFile::Open(input);
+  auto program = calc.Compile(expr, in.names());
+
+  std::vector<const double*> columns;
+  for (std::size_t i = 0; i < in.columns(); ++i)
+    columns.push_back(in.column(i));
+
+  auto out = ColumnFile::Create(output, {result}, in.rows());
+  program.EvaluateBatch(columns.data(), columns.size(), out.column(0),
+                        in.rows());
+
+  return in.rows();
+}
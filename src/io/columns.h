@@ -0,0 +1,65 @@
+#ifndef SMART_CALC_V2_IO_COLUMNS_H_
+#define SMART_CALC_V2_IO_COLUMNS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+#include "model/model.h"
+
+namespace s21::io {
+// Columnar sample file, all integers little-endian:
+//
+//   0   char[8]   magic "SCALCCOL"
+//   8   uint32    version (1)
+//   12  uint32    column count
+//   16  uint64    row count
+//   24  uint64    column stride in bytes (multiple of 64)
+//   32  char[32]  NUL-padded name, one per column
+//   ... column data, starting at the first 64-byte boundary after the
+//       names; column i begins stride * i bytes later.
+//
+// Columns are read and written in place through the mapping.
+class ColumnFile {
+ public:
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::size_t kNameSize = 32;
+  static constexpr std::size_t kAlignment = 64;
+
+ public:
+  static auto Open(const std::string& path) -> ColumnFile;
+  static auto Create(const std::string& path,
+                     const std::vector<std::string>& names, std::size_t rows)
+      -> ColumnFile;
+
+ public:
+  auto rows() const { return rows_; }
+  auto columns() const { return names_.size(); }
+  auto names() const -> const std::vector<std::string>& { return names_; }
+  auto column(std::size_t i) const -> const double*;
+  auto column(std::size_t i) -> double*;
+
+ private:
+  ColumnFile() = default;
+
+ private:
+  MappedFile file_;
+  std::vector<std::string> names_;
+  std::size_t rows_{0};
+  std::size_t stride_{0};
+  std::size_t data_{0};
+  bool writable_{false};
+};
+
+// Compiles expr with the input columns as its variables (by name) and
+// writes one output column, evaluated straight from and into the mappings.
+// Throws std::invalid_argument if output is the input file.
+auto EvaluateColumns(const SmartCalc&, std::string_view expr,
+                     const std::string& input, const std::string& output,
+                     const std::string& result = "y") -> std::size_t;
+}  // namespace s21::io
+
+#endif  // SMART_CALC_V2_IO_COLUMNS_H_
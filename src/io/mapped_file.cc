@@ -0,0 +1,99 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+static void Fail(const char* what, const std::string& path) {
+  throw std::runtime_error(std::string(what) + " '" + path +
+                           "': " + std::strerror(errno));
+}
+
+s21::io::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+s21::io::MappedFile::~MappedFile() { Reset_(); }
+
+auto s21::io::MappedFile::operator=(MappedFile&& rhs) noexcept
+    -> MappedFile& {
+  if (this != &rhs) {
+    Reset_();
+    data_ = std::exchange(rhs.data_, nullptr);
+    size_ = std::exchange(rhs.size_, 0);
+  }
+  return *this;
+}
+
+auto s21::io::MappedFile::OpenRead(const std::string& path) -> MappedFile {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) Fail("cannot open", path);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    Fail("cannot stat", path);
+  }
+
+  MappedFile file;
+  file.size_ = std::size_t(st.st_size);
+
+  if (file.size_ != 0) {
+    void* mem = mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) {
+      close(fd);
+      Fail("cannot map", path);
+    }
+    file.data_ = static_cast<char*>(mem);
+    madvise(mem, file.size_, MADV_SEQUENTIAL);
+  }
+
+  close(fd);
+  return file;
+}
+
+auto s21::io::MappedFile::Create(const std::string& path, std::size_t size)
+    -> MappedFile {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) Fail("cannot create", path);
+
+  if (ftruncate(fd, off_t(size)) != 0) {
+    close(fd);
+    Fail("cannot resize", path);
+  }
+
+  MappedFile file;
+  file.size_ = size;
+
+  if (size != 0) {
+    void* mem =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+      close(fd);
+      Fail("cannot map", path);
+    }
+    file.data_ = static_cast<char*>(mem);
+  }
+
+  close(fd);
+  return file;
+}
+
+auto s21::io::MappedFile::SameFile(const std::string& lhs,
+                                   const std::string& rhs) -> bool {
+  struct stat a, b;
+  return stat(lhs.c_str(), &a) == 0 && stat(rhs.c_str(), &b) == 0 &&
+         a.st_dev == b.st_dev && a.st_ino == b.st_ino;
+}
+
+void s21::io::MappedFile::Reset_() {
+  if (data_ != nullptr) munmap(data_, size_);
+  data_ = nullptr;
+  size_ = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef SMART_CALC_V2_IO_MAPPED_FILE_H_
+#define SMART_CALC_V2_IO_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace s21::io {
+// Owning POSIX file mapping. Input mappings are read-only and private;
+// output mappings are created at their final size and shared, so stores
+// land in the file.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+ public:
+  auto operator=(const MappedFile&) -> MappedFile& = delete;
+  auto operator=(MappedFile&& rhs) noexcept -> MappedFile&;
+
+ public:
+  static auto OpenRead(const std::string& path) -> MappedFile;
+  static auto Create(const std::string& path, std::size_t size) -> MappedFile;
+
+  // Whether both paths exist and name the same file. Create truncates, so
+  // callers check this before writing over a file they still read.
+  static auto SameFile(const std::string& lhs, const std::string& rhs)
+      -> bool;
+
+ public:
+  auto data() const { return data_; }
+  auto size() const { return size_; }
+  auto view() const { return std::string_view(data_, size_); }
+
+ private:
+  void Reset_();
+
+ private:
+  char* data_{nullptr};
+  std::size_t size_{0};
+};
+}  // namespace s21::io
+
+#endif  // SMART_CALC_V2_IO_MAPPED_FILE_H_
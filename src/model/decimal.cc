@@ -0,0 +1,98 @@
+#include "decimal.h"
+
+#ifndef __cpp_lib_to_chars
+#include <locale.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+#ifdef __cpp_lib_to_chars
+auto s21::decimal::FromChars(const char* first, const char* last,
+                             double& value) -> std::from_chars_result {
+  return std::from_chars(first, last, value);
+}
+
+auto s21::decimal::ToChars(char* first, char* last, double value)
+    -> std::to_chars_result {
+  return std::to_chars(first, last, value);
+}
+#else
+static auto ClassicLocale() -> locale_t {
+  static const locale_t locale = newlocale(LC_ALL_MASK, "C", nullptr);
+  return locale;
+}
+
+// strtod also takes leading blanks, a '+' sign and hexadecimal, which
+// from_chars does not: of "0x1p3" it reads only the "0".
+auto s21::decimal::FromChars(const char* first, const char* last,
+                             double& value) -> std::from_chars_result {
+  auto it = first != last && *first == '-' ? first + 1 : first;
+  if (it == last) return {first, std::errc::invalid_argument};
+
+  bool start = (*it >= '0' && *it <= '9') || *it == '.' || *it == 'i' ||
+               *it == 'I' || *it == 'n' || *it == 'N';
+  if (!start) return {first, std::errc::invalid_argument};
+  if (last - it > 1 && it[0] == '0' && (it[1] == 'x' || it[1] == 'X'))
+    last = it + 1;
+
+  // strtod needs a terminated copy; literals rarely outgrow the stack one.
+  char local[64];
+  std::string heap;
+  auto size = std::size_t(last - first);
+  char* text = local;
+
+  if (size < sizeof(local)) {
+    std::memcpy(local, first, size);
+    local[size] = '\0';
+  } else {
+    heap.assign(first, last);
+    text = heap.data();
+  }
+
+  char* end = nullptr;
+  errno = 0;
+  double parsed = strtod_l(text, &end, ClassicLocale());
+
+  if (end == text) return {first, std::errc::invalid_argument};
+
+  // Subnormal results also report ERANGE, but from_chars returns them.
+  if (errno == ERANGE && (parsed == 0 || std::isinf(parsed)))
+    return {first + (end - text), std::errc::result_out_of_range};
+
+  value = parsed;
+  return {first + (end - text), std::errc()};
+}
+
+// Up to 15 significant digits every double prints and reads back without
+// trailing zeros, so the first precision that round-trips is the shortest.
+auto s21::decimal::ToChars(char* first, char* last, double value)
+    -> std::to_chars_result {
+  std::string text;
+
+  for (int precision = 15; precision <= 17; ++precision) {
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+    ss.precision(precision);
+    ss << value;
+    text = ss.str();
+
+    if (strtod_l(text.c_str(), nullptr, ClassicLocale()) == value) break;
+  }
+
+  if (text.size() > std::size_t(last - first))
+    return {last, std::errc::value_too_large};
+
+  std::memcpy(first, text.data(), text.size());
+  return {first + text.size(), std::errc()};
+}
+#endif
@@ -0,0 +1,16 @@
+#ifndef SMART_CALC_V2_MODEL_DECIMAL_H_
+#define SMART_CALC_V2_MODEL_DECIMAL_H_
+
+#include <charconv>
+
+namespace s21::decimal {
+// std::from_chars and std::to_chars for double: locale-independent, plain
+// decimal input and shortest round-trip output. Standard libraries without
+// floating-point <charconv> (libc++ before LLVM 20, hence older Apple
+// Clang) get a fallback through strtod_l and the classic locale.
+auto FromChars(const char* first, const char* last, double& value)
+    -> std::from_chars_result;
+auto ToChars(char* first, char* last, double value) -> std::to_chars_result;
+}  // namespace s21::decimal
+
+#endif  // SMART_CALC_V2_MODEL_DECIMAL_H_
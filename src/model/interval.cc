@@ -0,0 +1,230 @@
+#include "interval.h"
+
+#include <algorithm>
+
+using s21::Interval;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kPi = 3.14159265358979323846;
+
+// Correctly rounded operations are off by at most half an ulp; glibc's
+// transcendental functions stay within one.
+constexpr int kExactUlps = 1;
+constexpr int kLibmUlps = 2;
+
+static auto Down(double x, int ulps) -> double {
+  while (ulps-- > 0) x = std::nextafter(x, -kInf);
+  return x;
+}
+
+static auto Up(double x, int ulps) -> double {
+  while (ulps-- > 0) x = std::nextafter(x, kInf);
+  return x;
+}
+
+// A NaN end means some combination had no value, so it is left unbounded.
+static auto Round(double lo, double hi, int ulps) -> Interval {
+  return {std::isnan(lo) ? -kInf : Down(lo, ulps),
+          std::isnan(hi) ? kInf : Up(hi, ulps)};
+}
+
+// For operations monotone in each argument the extremes sit at the
+// corners. Undefined corners are skipped, as the point evaluation would
+// produce NaN there.
+template <typename Op>
+static auto Corners(Interval a, Interval b, int ulps, Op op) -> Interval {
+  const double values[] = {op(a.lo, b.lo), op(a.lo, b.hi), op(a.hi, b.lo),
+                           op(a.hi, b.hi)};
+  double lo = values[0], hi = values[0];
+
+  for (double v : values) {
+    lo = std::fmin(lo, v);
+    hi = std::fmax(hi, v);
+  }
+
+  return std::isnan(lo) ? Interval::Empty() : Round(lo, hi, ulps);
+}
+
+static auto Increasing(double (*fn)(double), double lo, double hi)
+    -> Interval {
+  return Round(fn(lo), fn(hi), kLibmUlps);
+}
+
+// Whether a holds some point c + k * period, erring towards yes so that
+// rounding in the division can only widen the result.
+static auto Reaches(Interval a, double c, double period) -> bool {
+  double slack =
+      1e-9 * std::max({1.0, std::fabs(a.lo), std::fabs(a.hi)});
+  double k = std::ceil((a.lo - slack - c) / period);
+  return c + k * period <= a.hi + slack;
+}
+
+// sin and cos: top is a point where fn reaches 1, top + pi where it
+// reaches -1.
+static auto Periodic(double (*fn)(double), Interval a, double top)
+    -> Interval {
+  if (a.IsEmpty()) return a;
+  if (!(a.hi - a.lo < 2 * kPi)) return {-1, 1};
+
+  auto lo = fn(a.lo), hi = fn(a.hi);
+  auto result = Round(std::fmin(lo, hi), std::fmax(lo, hi), kLibmUlps);
+
+  if (Reaches(a, top, 2 * kPi)) result.hi = 1;
+  if (Reaches(a, top + kPi, 2 * kPi)) result.lo = -1;
+
+  return {std::fmax(result.lo, -1.0), std::fmin(result.hi, 1.0)};
+}
+
+static auto Abs(Interval a) -> Interval {
+  if (a.lo >= 0) return a;
+  if (a.hi <= 0) return {-a.hi, -a.lo};
+  return {0, std::fmax(-a.lo, a.hi)};
+}
+
+auto s21::interval::Add(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+  return Round(a.lo + b.lo, a.hi + b.hi, kExactUlps);
+}
+
+auto s21::interval::Sub(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+  return Round(a.lo - b.hi, a.hi - b.lo, kExactUlps);
+}
+
+// At a 0 * inf or inf / inf corner the points nearby can give anything
+// from 0 up to the infinite end. The other corners supply the infinity,
+// so the corner counts as 0, as in IEEE 1788.
+static auto ZeroIfNan(double x) -> double { return std::isnan(x) ? 0 : x; }
+
+auto s21::interval::Mul(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+  return Corners(a, b, kExactUlps,
+                 [](double x, double y) { return ZeroIfNan(x * y); });
+}
+
+auto s21::interval::Div(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+  if (b.Contains(0)) return Interval::Entire();
+  return Corners(a, b, kExactUlps,
+                 [](double x, double y) { return ZeroIfNan(x / y); });
+}
+
+// fmod is exact: the result has the sign of a and is smaller than both |a|
+// and |b|.
+auto s21::interval::Mod(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+
+  auto divisor = Abs(b);
+  if (-divisor.lo < a.lo && a.hi < divisor.lo) return a;
+
+  return {a.lo >= 0 ? 0 : std::fmax(a.lo, -divisor.hi),
+          a.hi <= 0 ? 0 : std::fmin(a.hi, divisor.hi)};
+}
+
+auto s21::interval::Pow(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+
+  auto pow = [](double x, double y) { return std::pow(x, y); };
+  bool point = b.lo == b.hi && std::isfinite(b.lo);
+
+  if (point && b.lo == std::trunc(b.lo)) {
+    auto n = b.lo;
+    bool odd = std::fmod(n, 2) != 0;
+
+    if (n == 0) return Interval::Point(1);
+    if (n < 0) return a.Contains(0) ? Interval::Entire()
+                                    : Corners(a, b, kLibmUlps, pow);
+    if (odd || a.lo >= 0)
+      return Round(pow(a.lo, n), pow(a.hi, n), kLibmUlps);
+    if (a.hi <= 0) return Round(pow(a.hi, n), pow(a.lo, n), kLibmUlps);
+
+    return {0, Up(std::fmax(pow(a.lo, n), pow(a.hi, n)), kLibmUlps)};
+  }
+
+  // A negative base has a value only at integer exponents.
+  if (a.lo < 0) {
+    if (!point) return Interval::Entire();
+    if (a.hi < 0) return Interval::Empty();
+    a.lo = 0;
+  }
+
+  return Corners(a, b, kLibmUlps, pow);
+}
+
+auto s21::interval::Neg(Interval a) -> Interval { return {-a.hi, -a.lo}; }
+
+auto s21::interval::Cos(Interval a) -> Interval {
+  return Periodic(std::cos, a, 0);
+}
+
+auto s21::interval::Sin(Interval a) -> Interval {
+  return Periodic(std::sin, a, kPi / 2);
+}
+
+auto s21::interval::Tan(Interval a) -> Interval {
+  if (a.IsEmpty()) return a;
+  if (!(a.hi - a.lo < kPi) || Reaches(a, kPi / 2, kPi))
+    return Interval::Entire();
+  return Increasing(std::tan, a.lo, a.hi);
+}
+
+auto s21::interval::Acos(Interval a) -> Interval {
+  if (a.IsEmpty() || a.hi < -1 || a.lo > 1) return Interval::Empty();
+  return Round(std::acos(std::fmin(a.hi, 1.0)),
+               std::acos(std::fmax(a.lo, -1.0)), kLibmUlps);
+}
+
+auto s21::interval::Asin(Interval a) -> Interval {
+  if (a.IsEmpty() || a.hi < -1 || a.lo > 1) return Interval::Empty();
+  return Increasing(std::asin, std::fmax(a.lo, -1.0), std::fmin(a.hi, 1.0));
+}
+
+auto s21::interval::Atan(Interval a) -> Interval {
+  if (a.IsEmpty()) return a;
+  return Increasing(std::atan, a.lo, a.hi);
+}
+
+auto s21::interval::Sqrt(Interval a) -> Interval {
+  if (a.IsEmpty() || a.hi < 0) return Interval::Empty();
+  return Round(std::sqrt(std::fmax(a.lo, 0.0)), std::sqrt(a.hi), kExactUlps);
+}
+
+auto s21::interval::Log(Interval a) -> Interval {
+  if (a.IsEmpty() || a.hi < 0) return Interval::Empty();
+  return Increasing(std::log, std::fmax(a.lo, 0.0), a.hi);
+}
+
+auto s21::interval::Log10(Interval a) -> Interval {
+  if (a.IsEmpty() || a.hi < 0) return Interval::Empty();
+  return Increasing(std::log10, std::fmax(a.lo, 0.0), a.hi);
+}
+
+// Off the negative x axis, where the branch cut lies, the angle over a
+// rectangle is extreme at its corners.
+auto s21::interval::Atan2(Interval y, Interval x) -> Interval {
+  if (y.IsEmpty() || x.IsEmpty()) return Interval::Empty();
+  if (x.lo > 0 || y.lo > 0 || y.hi < 0)
+    return Corners(y, x, kLibmUlps,
+                   [](double u, double v) { return std::atan2(u, v); });
+  return Round(-kPi, kPi, kLibmUlps);
+}
+
+auto s21::interval::Hypot(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty() || b.IsEmpty()) return Interval::Empty();
+
+  auto x = Abs(a), y = Abs(b);
+  return Round(std::hypot(x.lo, y.lo), std::hypot(x.hi, y.hi), kLibmUlps);
+}
+
+// fmin and fmax ignore a NaN operand, so an empty side drops out.
+auto s21::interval::Min(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty()) return b;
+  if (b.IsEmpty()) return a;
+  return {std::fmin(a.lo, b.lo), std::fmin(a.hi, b.hi)};
+}
+
+auto s21::interval::Max(Interval a, Interval b) -> Interval {
+  if (a.IsEmpty()) return b;
+  if (b.IsEmpty()) return a;
+  return {std::fmax(a.lo, b.lo), std::fmax(a.hi, b.hi)};
+}
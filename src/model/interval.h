@@ -0,0 +1,60 @@
+#ifndef SMART_CALC_V2_MODEL_INTERVAL_H_
+#define SMART_CALC_V2_MODEL_INTERVAL_H_
+
+#include <cmath>
+#include <limits>
+
+namespace s21 {
+// Closed range of doubles. Results are rounded outward: every endpoint
+// computed in floating point is stepped one ulp away from the range (two
+// for libm calls), so the bounds hold whatever rounding the point
+// evaluation saw. Values outside a function's domain are ignored, like the
+// NaN they produce; a range where nothing is defined is empty (NaN ends).
+struct Interval {
+  double lo{0};
+  double hi{0};
+
+  static constexpr auto Point(double x) -> Interval { return {x, x}; }
+  static constexpr auto Entire() -> Interval {
+    return {-std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity()};
+  }
+  static constexpr auto Empty() -> Interval {
+    return {std::numeric_limits<double>::quiet_NaN(),
+            std::numeric_limits<double>::quiet_NaN()};
+  }
+
+  constexpr auto IsEmpty() const { return !(lo <= hi); }
+  constexpr auto Contains(double x) const { return lo <= x && x <= hi; }
+  constexpr auto operator==(const Interval& other) const {
+    return lo == other.lo && hi == other.hi;
+  }
+};
+
+namespace interval {
+auto Add(Interval, Interval) -> Interval;
+auto Sub(Interval, Interval) -> Interval;
+auto Mul(Interval, Interval) -> Interval;
+auto Div(Interval, Interval) -> Interval;
+auto Mod(Interval, Interval) -> Interval;
+auto Pow(Interval, Interval) -> Interval;
+auto Neg(Interval) -> Interval;
+
+auto Cos(Interval) -> Interval;
+auto Sin(Interval) -> Interval;
+auto Tan(Interval) -> Interval;
+auto Acos(Interval) -> Interval;
+auto Asin(Interval) -> Interval;
+auto Atan(Interval) -> Interval;
+auto Sqrt(Interval) -> Interval;
+auto Log(Interval) -> Interval;
+auto Log10(Interval) -> Interval;
+
+auto Atan2(Interval, Interval) -> Interval;
+auto Hypot(Interval, Interval) -> Interval;
+auto Min(Interval, Interval) -> Interval;
+auto Max(Interval, Interval) -> Interval;
+}  // namespace interval
+}  // namespace s21
+
+#endif  // SMART_CALC_V2_MODEL_INTERVAL_H_
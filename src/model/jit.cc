@@ -0,0 +1,174 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "model.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#define SMART_CALC_JIT 1
+#endif
+
+#ifdef SMART_CALC_JIT
+namespace {
+// Minimal x86-64 emitter for the handful of SSE2 instructions the register
+// bytecode needs. Every register lives in the frame addressed by rbx; the
+// stack holds an aligned argument array for n-ary calls.
+class Assembler {
+ public:
+  static constexpr std::uint8_t kArgsSize = 64;
+
+  void Prologue() {
+    Bytes({0x53});                         // push rbx
+    Bytes({0x48, 0x89, 0xFB});             // mov rbx, rdi
+    Bytes({0x48, 0x83, 0xEC, kArgsSize});  // sub rsp, imm8
+  }
+
+  void Epilogue(std::uint32_t result) {
+    Load(0, result);
+    Bytes({0x48, 0x83, 0xC4, kArgsSize});  // add rsp, imm8
+    Bytes({0x5B, 0xC3});                   // pop rbx; ret
+  }
+
+  void Load(int xmm, std::uint32_t reg) {
+    Bytes({0xF2, 0x0F, 0x10});  // movsd xmm, [rbx + disp32]
+    Frame(xmm, reg);
+  }
+
+  void Store(std::uint32_t reg) {
+    Bytes({0xF2, 0x0F, 0x11});  // movsd [rbx + disp32], xmm0
+    Frame(0, reg);
+  }
+
+  void Arith(std::uint8_t opcode, std::uint32_t reg) {
+    Bytes({0xF2, 0x0F, opcode});  // addsd/subsd/mulsd/divsd xmm0, [mem]
+    Frame(0, reg);
+  }
+
+  void Negate(std::uint32_t dst, std::uint32_t src) {
+    Bytes({0x48, 0x8B});  // mov rax, [rbx + disp32]
+    Frame(0, src);
+    Bytes({0x48, 0x0F, 0xBA, 0xF8, 0x3F});  // btc rax, 63
+    Bytes({0x48, 0x89});                    // mov [rbx + disp32], rax
+    Frame(0, dst);
+  }
+
+  void StoreArg(std::uint8_t index) {
+    // movsd [rsp + disp8], xmm0
+    Bytes({0xF2, 0x0F, 0x11, 0x44, 0x24, std::uint8_t(index * 8)});
+  }
+
+  void ArgsPointer() {
+    Bytes({0x48, 0x89, 0xE7});  // mov rdi, rsp
+  }
+
+  void Call(const void* fn) {
+    std::uint64_t addr = reinterpret_cast<std::uintptr_t>(fn);
+    Bytes({0x48, 0xB8});  // mov rax, imm64
+    for (int i = 0; i < 8; ++i) code_.push_back((addr >> (8 * i)) & 0xFF);
+    Bytes({0xFF, 0xD0});  // call rax
+  }
+
+  auto code() const -> const std::vector<std::uint8_t>& { return code_; }
+
+ private:
+  void Bytes(std::initializer_list<std::uint8_t> bytes) {
+    code_.insert(code_.end(), bytes);
+  }
+
+  void Frame(int reg_field, std::uint32_t slot) {
+    std::uint32_t disp = slot * sizeof(double);
+    code_.push_back(0x83 | (reg_field << 3));  // mod=10, rm=rbx
+    for (int i = 0; i < 4; ++i) code_.push_back((disp >> (8 * i)) & 0xFF);
+  }
+
+ private:
+  std::vector<std::uint8_t> code_;
+};
+}  // namespace
+#endif
+
+auto s21::CompiledExpression::Jit_() -> bool {
+#ifdef SMART_CALC_JIT
+  static_assert(Assembler::kArgsSize ==
+                FunctionRegistry::kMaxArity * sizeof(double));
+
+  if (calls_registered_) return false;
+
+  Assembler as;
+  as.Prologue();
+
+  for (auto& instr : code_) {
+    switch (instr.op) {
+      case Op::Add:
+      case Op::Sub:
+      case Op::Mul:
+      case Op::Div: {
+        constexpr std::uint8_t opcodes[] = {0x58, 0x5C, 0x59, 0x5E};
+        as.Load(0, instr.lhs);
+        as.Arith(opcodes[static_cast<int>(instr.op)], instr.rhs);
+        as.Store(instr.dst);
+      } break;
+
+      case Op::Mod:
+      case Op::Pow: {
+        using BinaryFn = SmartCalc::BinaryFn;
+        BinaryFn fn = instr.op == Op::Mod ? static_cast<BinaryFn>(std::fmod)
+                                          : static_cast<BinaryFn>(std::pow);
+        as.Load(0, instr.lhs);
+        as.Load(1, instr.rhs);
+        as.Call(reinterpret_cast<const void*>(fn));
+        as.Store(instr.dst);
+      } break;
+
+      case Op::Neg:
+        as.Negate(instr.dst, instr.lhs);
+        break;
+
+      case Op::Call:
+        as.Load(0, instr.lhs);
+        as.Call(reinterpret_cast<const void*>(instr.fn.unary));
+        as.Store(instr.dst);
+        break;
+
+      case Op::Call2:
+        as.Load(0, instr.lhs);
+        as.Load(1, instr.rhs);
+        as.Call(reinterpret_cast<const void*>(instr.fn.binary));
+        as.Store(instr.dst);
+        break;
+
+      case Op::CallN:
+        for (Reg i = 0; i < instr.rhs; ++i) {
+          as.Load(0, args_[instr.lhs + i]);
+          as.StoreArg(std::uint8_t(i));
+        }
+        as.ArgsPointer();
+        as.Call(reinterpret_cast<const void*>(instr.fn.nary));
+        as.Store(instr.dst);
+        break;
+    }
+  }
+
+  as.Epilogue(result_);
+
+  auto size = as.code().size();
+  void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) return false;
+
+  std::memcpy(mem, as.code().data(), size);
+  if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(mem, size);
+    return false;
+  }
+
+  native_mem_.reset(mem, [size](void* ptr) { munmap(ptr, size); });
+  native_ = reinterpret_cast<NativeFn>(mem);
+
+  return true;
+#else
+  return false;
+#endif
+}
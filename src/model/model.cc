@@ -1,33 +1,110 @@
 #include "model.h"
 
-#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cmath>
 #include <cstring>
-#include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <tuple>
 
-#define APPLY_OP(STACK_NAME, EXPR) \
-  STACK_NAME.push_back(            \
-      ApplyOperator(STACK_NAME, [](auto lhs, auto rhs) { return EXPR; }))
+#include "parser.h"
+#include "simd.h"
+#include "static_expr.h"
 
-static auto isop(char c) {
-  return c == '+' || c == '-' || c == '*' || c == '/' || c == '%' || c == '^' ||
-         c == '(' || c == ')';
+#define APPLY_OP(LANES, DST, LHS, RHS, N, EXPR) \
+  simd::Binary<LANES>(DST, LHS, RHS, N,         \
+                      [](auto lhs, auto rhs) { return EXPR; })
+
+constexpr std::size_t kBatchBlock = 256;
+
+template <s21::Interval (*Fn)(s21::Interval)>
+static auto Unary(const s21::Interval* args) -> s21::Interval {
+  return Fn(args[0]);
 }
 
-static auto ApplyOperator(std::vector<double>& stack,
-                          std::function<double(double, double)> cb) {
-  if (stack.size() < 2)
-    throw std::invalid_argument("cannot apply operator (Stack Underflow)");
+template <s21::Interval (*Fn)(s21::Interval, s21::Interval)>
+static auto Binary(const s21::Interval* args) -> s21::Interval {
+  return Fn(args[0], args[1]);
+}
+
+// Phase counters, compiled in only with -DSMARTCALC_STATS. All updates are
+// relaxed: a snapshot taken during concurrent use is approximate.
+#ifdef SMARTCALC_STATS
+namespace {
+struct PhaseCounter {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> nanoseconds{0};
+};
+
+struct Counters {
+  PhaseCounter lex;
+  PhaseCounter parse;
+  PhaseCounter compile;
+  PhaseCounter evaluate;
+  std::atomic<std::uint64_t> tokens{0};
+  std::atomic<std::uint64_t> values{0};
+  std::atomic<std::uint64_t> max_frame{0};
+};
+
+Counters counters;
+
+class ScopedPhase {
+ public:
+  explicit ScopedPhase(PhaseCounter& phase)
+      : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedPhase() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    phase_.calls.fetch_add(1, std::memory_order_relaxed);
+    phase_.nanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() -
+            split_,
+        std::memory_order_relaxed);
+  }
+
+  // Books nanoseconds of this scope to another phase instead.
+  void Split(PhaseCounter& phase, std::uint64_t nanoseconds) {
+    phase.calls.fetch_add(1, std::memory_order_relaxed);
+    phase.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    split_ += nanoseconds;
+  }
+
+ private:
+  PhaseCounter& phase_;
+  std::chrono::steady_clock::time_point start_;
+  std::uint64_t split_{0};
+};
+
+void RaiseMax(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+  auto current = counter.load(std::memory_order_relaxed);
+  while (current < value &&
+         !counter.compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed))
+    ;
+}
 
-  double rhs = stack.back();
-  stack.pop_back();
-  double lhs = stack.back();
-  stack.pop_back();
-  return cb(lhs, rhs);
+auto Snapshot(const PhaseCounter& phase) -> s21::PhaseStats {
+  return {phase.calls.load(std::memory_order_relaxed),
+          phase.nanoseconds.load(std::memory_order_relaxed)};
 }
+}  // namespace
+
+#define SMARTCALC_PHASE(PHASE) ScopedPhase scoped_phase(counters.PHASE)
+#define SMARTCALC_COUNT(COUNTER, N) \
+  counters.COUNTER.fetch_add(N, std::memory_order_relaxed)
+#define SMARTCALC_MAX(COUNTER, VALUE) RaiseMax(counters.COUNTER, VALUE)
+#define SMARTCALC_SPLIT(PHASE, NS) scoped_phase.Split(counters.PHASE, NS)
+#else
+#define SMARTCALC_PHASE(PHASE)
+#define SMARTCALC_COUNT(COUNTER, N)
+#define SMARTCALC_MAX(COUNTER, VALUE)
+#define SMARTCALC_SPLIT(PHASE, NS)
+#endif
+
+static constexpr char kAnnuityPayment[] = "p * (r / (1 - (1 + r) ^ -n))";
 
 auto s21::assertd(double lhs, double rhs) -> bool {
   return fabs(lhs - rhs) < EPS;
@@ -69,17 +146,13 @@ auto s21::Token::c_str() const -> const char* {
       return "Function";
     case Kind::Ident:
       return "Ident";
+    case Kind::Comma:
+      return "Comma";
     default:
       return "???";
   }
 }
 
-auto s21::Token::IsOperator() const -> bool {
-  return kind_ == Kind::Negate || kind_ == Kind::PlusOp ||
-         kind_ == Kind::MinusOp || kind_ == Kind::MulOp ||
-         kind_ == Kind::DivOp || kind_ == Kind::ModOp || kind_ == Kind::ExpOp;
-}
-
 std::ostream& s21::operator<<(std::ostream& s, const Token& t) {
   s << "Token::" << t.c_str();
 
@@ -99,26 +172,6 @@ std::ostream& s21::operator<<(std::ostream& s, const Token& t) {
   return s;
 }
 
-auto s21::Lexer::Next() -> Token {
-  Token t;
-
-  while (it_ != end_ && std::isspace(*it_)) it_++;
-  if (it_ == end_) return Token::EndStream();
-
-  if (std::isdigit(*it_))
-    t = Digit_();
-  else if (isop(*it_))
-    t = Operator_();
-  else if (std::isalpha(*it_))
-    t = Ident_();
-  else
-    t = Token::Invalid({it_++, 1});
-
-  prev_ = t;
-
-  return t;
-}
-
 auto s21::Lexer::Collect() -> std::vector<Token> {
   std::vector<Token> tokens;
   for (auto tok = Next(); tok != Token::EndStream(); tok = Next())
@@ -126,243 +179,660 @@ auto s21::Lexer::Collect() -> std::vector<Token> {
   return tokens;
 }
 
-auto s21::Lexer::Digit_() -> Token {
-  std::size_t n = 0;
-  auto start = it_;
-  bool have_dec_point = false;
-  for (; it_ != end_ && strchr("1234567890.", *it_); ++it_, ++n)
-    if (*it_ == '.' && !have_dec_point)
-      have_dec_point = true;
-    else if (*it_ == '.' && have_dec_point)
-      break;
-  return Token::Number({start, n});
+auto s21::SmartCalc::Compile(std::string_view expr, Tier tier) const
+    -> CompiledExpression {
+  return Compile(expr, {"x"}, tier);
 }
 
-auto s21::Lexer::Operator_() -> Token {
-  switch (*(it_++)) {
-    case '+': {
-      if (prev_ == Token::StartStream() || prev_.IsOperator())
-        return Token::Whitespace();
-      return Token::PlusOp();
+auto s21::SmartCalc::Compile(std::string_view expr, const Variables& vars,
+                             Tier tier) const -> CompiledExpression {
+  for (auto it = vars.begin(); it != vars.end(); ++it) {
+    Lexer lexer(*it);
+
+    if (lexer.Next() != Token::Ident(*it) || functions_.Find(*it) ||
+        std::find(vars.begin(), it, *it) != it) {
+      std::stringstream ss;
+      ss << "invalid variable name '" << *it << "'";
+      throw std::invalid_argument(ss.str());
     }
-    case '-': {
-      if (prev_ == Token::StartStream() ||
-          ((prev_.IsOperator() || prev_.IsOpenBrace()) &&
-           !prev_.IsCloseBrace()))
-        return Token::Negate();
-      return Token::MinusOp();
+  }
+
+  ExprDag dag;
+  ExprDag::NodeId root;
+
+  {
+    SMARTCALC_PHASE(parse);
+    thread_local Arena arena;
+    Parser parser(functions_, vars, arena);
+
+    arena.Reset();
+    auto ast = parser.Parse(expr);
+
+    SMARTCALC_COUNT(tokens, parser.tokens());
+    SMARTCALC_SPLIT(lex, parser.lex_nanoseconds());
+    root = BuildDag_(ast, dag);
+  }
+
+  SMARTCALC_PHASE(compile);
+  CompiledExpression compiled(dag, root, vars.size());
+  if (tier == Tier::Jit) compiled.Jit_();
+
+  return compiled;
+}
+
+auto s21::SmartCalc::Stats() -> EngineStats {
+#ifdef SMARTCALC_STATS
+  return {Snapshot(counters.lex),
+          Snapshot(counters.parse),
+          Snapshot(counters.compile),
+          Snapshot(counters.evaluate),
+          counters.tokens.load(std::memory_order_relaxed),
+          counters.values.load(std::memory_order_relaxed),
+          counters.max_frame.load(std::memory_order_relaxed)};
+#else
+  return {};
+#endif
+}
+
+void s21::SmartCalc::ResetStats() {
+#ifdef SMARTCALC_STATS
+  for (auto phase : {&counters.lex, &counters.parse, &counters.compile,
+                     &counters.evaluate}) {
+    phase->calls.store(0, std::memory_order_relaxed);
+    phase->nanoseconds.store(0, std::memory_order_relaxed);
+  }
+  counters.tokens.store(0, std::memory_order_relaxed);
+  counters.values.store(0, std::memory_order_relaxed);
+  counters.max_frame.store(0, std::memory_order_relaxed);
+#endif
+}
+
+auto s21::SmartCalc::Evaluate(std::string_view expr, double x) const
+    -> double {
+  return Compile(expr).Evaluate(x);
+}
+
+void s21::SmartCalc::EvaluateBatch(std::string_view expr, const double* xs,
+                                   double* out, std::size_t n) const {
+  Compile(expr).EvaluateBatch(xs, out, n);
+}
+
+auto s21::SmartCalc::EvaluateInterval(std::string_view expr, Interval x) const
+    -> Interval {
+  return Compile(expr).EvaluateInterval(x);
+}
+
+s21::CompiledExpression::CompiledExpression(const ExprDag& dag,
+                                           ExprDag::NodeId root,
+                                           std::size_t vars)
+    : vars_(Reg(vars)) {
+  std::vector<bool> live(root + 1, false);
+  std::vector<ExprDag::NodeId> last_use(root + 1, 0);
+  std::vector<Reg> regs(root + 1, 0);
+
+  // Operands always precede their users, so a reverse walk from the root
+  // marks every reachable node together with the last instruction using it.
+  live[root] = true;
+  last_use[root] = root + 1;
+  for (auto id = root + 1; id-- > 0;) {
+    auto& node = dag[id];
+    if (!live[id]) continue;
+
+    for (std::size_t i = 0; i < node.arity(); ++i) {
+      auto arg = node.args[i];
+      live[arg] = true;
+      last_use[arg] = std::max(last_use[arg], id);
     }
-    case '*': {
-      if (prev_ == Token::StartStream()) return Token();
-      return Token::MulOp();
+  }
+
+  frame_.assign(vars_, 0);
+  for (ExprDag::NodeId id = 0; id <= root; ++id) {
+    if (live[id] && dag[id].kind == Token::Kind::Variable) {
+      regs[id] = dag[id].slot;
+    } else if (live[id] && dag[id].IsNumber()) {
+      regs[id] = Reg(frame_.size());
+      frame_.push_back(dag[id].value);
     }
-    case '/': {
-      if (prev_ == Token::StartStream()) return Token();
-      return Token::DivOp();
+  }
+
+  const auto base = Reg(frame_.size());
+  std::vector<Reg> free_temps;
+  Reg temps = 0;
+
+  auto release = [&](const ExprDag::Node& node, ExprDag::NodeId user) {
+    auto args = node.args.begin();
+    for (auto it = args; it != args + node.arity(); ++it)
+      if (last_use[*it] == user && regs[*it] >= base &&
+          std::find(args, it, *it) == it)
+        free_temps.push_back(regs[*it]);
+  };
+
+  for (ExprDag::NodeId id = 0; id <= root; ++id) {
+    auto& node = dag[id];
+    if (!live[id] || node.arity() == 0) continue;
+
+    release(node, id);
+
+    Reg dst = base + temps;
+    if (free_temps.empty()) {
+      ++temps;
+    } else {
+      dst = free_temps.back();
+      free_temps.pop_back();
     }
-    case '%': {
-      if (prev_ == Token::StartStream()) return Token();
-      return Token::ModOp();
+
+    Instr instr{ToOp_(node), dst, regs[node.args[0]],
+                node.arity() == 2 ? regs[node.args[1]] : 0,
+                ToCallee_(node.fn), node.fn ? node.fn->batch : nullptr};
+
+    if (instr.op == Op::CallN) {
+      instr.lhs = Reg(args_.size());
+      instr.rhs = Reg(node.arity());
+      for (std::size_t i = 0; i < node.arity(); ++i)
+        args_.push_back(regs[node.args[i]]);
     }
-    case '^': {
-      if (prev_ == Token::StartStream()) return Token();
-      return Token::ExpOp();
+
+    code_.push_back(instr);
+    intervals_.push_back(node.fn ? node.fn->interval : nullptr);
+    if (node.fn && !node.fn->builtin) calls_registered_ = true;
+    regs[id] = dst;
+  }
+
+  frame_.resize(base + temps);
+  SMARTCALC_MAX(max_frame, frame_.size());
+  result_ = regs[root];
+}
+
+auto s21::CompiledExpression::Evaluate(double x) const -> double {
+  return Evaluate(&x, std::min<std::size_t>(vars_, 1));
+}
+
+auto s21::CompiledExpression::Evaluate(const double* values,
+                                       std::size_t n) const -> double {
+  if (n > vars_) throw std::invalid_argument("too many variable values");
+
+  SMARTCALC_PHASE(evaluate);
+  SMARTCALC_COUNT(values, 1);
+
+  // Larger frames reuse a per-thread buffer. It is taken out while in use,
+  // so a user function that evaluates another large expression gets its
+  // own.
+  if (frame_.size() > kInlineFrame) {
+    thread_local std::vector<double> scratch;
+    auto regs = std::move(scratch);
+    regs.assign(frame_.begin(), frame_.end());
+    std::copy(values, values + n, regs.begin());
+
+    auto result = Execute_(regs.data());
+    scratch = std::move(regs);
+    return result;
+  }
+
+  std::array<double, kInlineFrame> regs;
+  std::copy(frame_.begin(), frame_.end(), regs.begin());
+  std::copy(values, values + n, regs.begin());
+
+  return Execute_(regs.data());
+}
+
+auto s21::CompiledExpression::Execute_(double* regs) const -> double {
+  if (native_) return native_(regs);
+
+  for (auto& instr : code_) {
+    if (instr.op == Op::CallN) {
+      std::array<double, FunctionRegistry::kMaxArity> args;
+      auto operands = args_.data() + instr.lhs;
+
+      for (Reg i = 0; i < instr.rhs; ++i) args[i] = regs[operands[i]];
+      regs[instr.dst] = instr.fn.nary(args.data());
+    } else {
+      regs[instr.dst] =
+          Apply_(instr.op, regs[instr.lhs], regs[instr.rhs], instr.fn);
     }
-    case '(':
-      return Token::OpenBrace();
-    case ')': {
-      if (prev_ == Token::StartStream()) return Token();
-      return Token::CloseBrace();
+  }
+
+  return regs[result_];
+}
+
+auto s21::CompiledExpression::EvaluateInterval(Interval x) const
+    -> Interval {
+  return EvaluateInterval(&x, std::min<std::size_t>(vars_, 1));
+}
+
+auto s21::CompiledExpression::EvaluateInterval(const Interval* values,
+                                               std::size_t n) const
+    -> Interval {
+  if (n > vars_) throw std::invalid_argument("too many variable values");
+  if (std::any_of(values, values + n, [](auto v) { return v.IsEmpty(); }))
+    throw std::invalid_argument("invalid variable range");
+
+  SMARTCALC_PHASE(evaluate);
+  SMARTCALC_COUNT(values, 1);
+
+  std::vector<Interval> regs(frame_.size());
+  for (std::size_t r = 0; r < regs.size(); ++r)
+    regs[r] = r < n ? values[r] : Interval::Point(frame_[r]);
+
+  for (std::size_t i = 0; i < code_.size(); ++i) {
+    auto& instr = code_[i];
+    auto lhs = regs[instr.lhs], rhs = regs[instr.rhs];
+    std::array<Interval, FunctionRegistry::kMaxArity> args{lhs, rhs};
+
+    switch (instr.op) {
+      case Op::Add:
+        regs[instr.dst] = interval::Add(lhs, rhs);
+        continue;
+      case Op::Sub:
+        regs[instr.dst] = interval::Sub(lhs, rhs);
+        continue;
+      case Op::Mul:
+        regs[instr.dst] = interval::Mul(lhs, rhs);
+        continue;
+      case Op::Div:
+        regs[instr.dst] = interval::Div(lhs, rhs);
+        continue;
+      case Op::Mod:
+        regs[instr.dst] = interval::Mod(lhs, rhs);
+        continue;
+      case Op::Pow:
+        regs[instr.dst] = interval::Pow(lhs, rhs);
+        continue;
+      case Op::Neg:
+        regs[instr.dst] = interval::Neg(lhs);
+        continue;
+      case Op::CallN:
+        for (Reg k = 0; k < instr.rhs; ++k)
+          args[k] = regs[args_[instr.lhs + k]];
+        break;
+      case Op::Call:
+      case Op::Call2:
+        break;
     }
+
+    auto fn = intervals_[i];
+    regs[instr.dst] = fn ? fn(args.data()) : Interval::Entire();
+  }
+
+  return regs[result_];
+}
+
+auto s21::CompiledExpression::ToOp_(const ExprDag::Node& node) -> Op {
+  switch (node.kind) {
+    case Token::Kind::MinusOp:
+      return Op::Sub;
+    case Token::Kind::MulOp:
+      return Op::Mul;
+    case Token::Kind::DivOp:
+      return Op::Div;
+    case Token::Kind::ModOp:
+      return Op::Mod;
+    case Token::Kind::ExpOp:
+      return Op::Pow;
+    case Token::Kind::Negate:
+      return Op::Neg;
+    case Token::Kind::Function:
+      return node.fn->arity == 1   ? Op::Call
+             : node.fn->arity == 2 ? Op::Call2
+                                   : Op::CallN;
     default:
-      return Token::Invalid({it_ - 1});
+      return Op::Add;
   }
 }
 
-auto s21::Lexer::Ident_() -> Token {
-  std::size_t n = 0;
-  auto start = it_;
-  for (; it_ != end_ && std::isalnum(*it_); ++it_, ++n)
-    ;
-  return Token::Ident({start, n});
+auto s21::CompiledExpression::ToCallee_(const FunctionRegistry::Entry* fn)
+    -> Callee {
+  Callee callee{nullptr};
+
+  if (fn == nullptr)
+    return callee;
+  else if (fn->arity == 1)
+    callee.unary = fn->fn;
+  else if (fn->arity == 2)
+    callee.binary = fn->binary;
+  else
+    callee.nary = fn->nary;
+
+  return callee;
+}
+
+auto s21::CompiledExpression::Apply_(Op op, double lhs, double rhs,
+                                     Callee fn) -> double {
+  switch (op) {
+    case Op::Add:
+      return lhs + rhs;
+    case Op::Sub:
+      return lhs - rhs;
+    case Op::Mul:
+      return lhs * rhs;
+    case Op::Div:
+      return lhs / rhs;
+    case Op::Mod:
+      return std::fmod(lhs, rhs);
+    case Op::Pow:
+      return std::pow(lhs, rhs);
+    case Op::Neg:
+      return -lhs;
+    case Op::Call:
+      return fn.unary(lhs);
+    case Op::Call2:
+      return fn.binary(lhs, rhs);
+    case Op::CallN:
+      break;
+  }
+
+  return lhs;
 }
 
-double s21::SmartCalc::Evaluate(std::string_view expr, double x) {
-  Clear_();
-  Parse_(expr);
+void s21::CompiledExpression::EvaluateBatch(const double* xs, double* out,
+                                            std::size_t n) const {
+  EvaluateBatch(&xs, std::min<std::size_t>(vars_, 1), out, n);
+}
+
+void s21::CompiledExpression::EvaluateBatch(const double* const* columns,
+                                            std::size_t vars, double* out,
+                                            std::size_t n) const {
+  if (vars > vars_) throw std::invalid_argument("too many variable columns");
+
+  SMARTCALC_PHASE(evaluate);
+  SMARTCALC_COUNT(values, n);
+
+  if (native_) {
+    std::vector<double> regs(frame_);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t v = 0; v < vars; ++v) regs[v] = columns[v][i];
+      out[i] = native_(regs.data());
+    }
+    return;
+  }
+
+  std::vector<double> block(frame_.size() * kBatchBlock);
+  std::vector<double*> regs(frame_.size());
+
+  for (std::size_t r = 0; r < regs.size(); ++r) {
+    regs[r] = block.data() + r * kBatchBlock;
+    std::fill(regs[r], regs[r] + kBatchBlock, frame_[r]);
+  }
+
+  for (std::size_t base = 0; base < n; base += kBatchBlock) {
+    auto len = std::min(kBatchBlock, n - base);
+    for (std::size_t v = 0; v < vars; ++v)
+      std::copy(columns[v] + base, columns[v] + base + len, regs[v]);
+    Run_(regs.data(), len);
+    std::copy(regs[result_], regs[result_] + len, out + base);
+  }
+}
 
-  std::vector<double> stack{};
+void s21::CompiledExpression::Run_(double* const* regs, std::size_t n) const {
+  for (auto& instr : code_) {
+    auto dst = regs[instr.dst];
+    auto a = instr.op == Op::CallN ? nullptr : regs[instr.lhs];
+    auto b = instr.op == Op::CallN ? nullptr : regs[instr.rhs];
 
-  for (auto& tok : ca_) {
-    switch (tok.kind()) {
-      case Token::Kind::Number:
-        stack.push_back(std::atof(tok.val().data()));
+    switch (instr.op) {
+      case Op::Add:
+        APPLY_OP(simd::Packed, dst, a, b, n, lhs + rhs);
         break;
 
-      case Token::Kind::Variable:
-        stack.push_back(x);
+      case Op::Sub:
+        APPLY_OP(simd::Packed, dst, a, b, n, lhs - rhs);
         break;
 
-      case Token::Kind::PlusOp:
-        APPLY_OP(stack, lhs + rhs);
+      case Op::Mul:
+        APPLY_OP(simd::Packed, dst, a, b, n, lhs * rhs);
         break;
 
-      case Token::Kind::MinusOp:
-        APPLY_OP(stack, lhs - rhs);
+      case Op::Div:
+        APPLY_OP(simd::Packed, dst, a, b, n, lhs / rhs);
         break;
 
-      case Token::Kind::MulOp:
-        APPLY_OP(stack, lhs * rhs);
+      case Op::Mod:
+        APPLY_OP(simd::Scalar, dst, a, b, n, std::fmod(lhs, rhs));
         break;
 
-      case Token::Kind::DivOp:
-        APPLY_OP(stack, lhs / rhs);
+      case Op::Pow:
+        APPLY_OP(simd::Scalar, dst, a, b, n, std::pow(lhs, rhs));
         break;
 
-      case Token::Kind::ModOp:
-        APPLY_OP(stack, std::fmod(lhs, rhs));
+      case Op::Neg:
+        simd::Unary(dst, a, n, [](auto val) { return -val; });
         break;
 
-      case Token::Kind::ExpOp:
-        APPLY_OP(stack, std::pow(lhs, rhs));
+      case Op::Call:
+        if (instr.batch)
+          instr.batch(a, dst, n);
+        else
+          for (std::size_t i = 0; i < n; ++i) dst[i] = instr.fn.unary(a[i]);
         break;
 
-      case Token::Kind::Negate: {
-        if (stack.size() < 1) {
-          constexpr auto msg = "cannot apply negation (Stack Underflow)";
-          throw std::invalid_argument(msg);
-        }
+      case Op::Call2:
+        for (std::size_t i = 0; i < n; ++i)
+          dst[i] = instr.fn.binary(a[i], b[i]);
+        break;
 
-        auto& val = stack.back();
-        val = -val;
-      } break;
+      case Op::CallN: {
+        std::array<double, FunctionRegistry::kMaxArity> args;
+        auto operands = args_.data() + instr.lhs;
 
-      case Token::Kind::Function: {
-        auto fn_ptr = ResolveMathFnName_(tok.val());
-
-        if (fn_ptr != nullptr) {
-          if (stack.size() < 1) {
-            constexpr auto msg =
-                "cannot evaluate function call (Stack Underflow)";
-            throw std::invalid_argument(msg);
-          }
-
-          double& val = stack.back();
-          val = fn_ptr(val);
-        } else {
-          std::stringstream ss;
-          ss << "invalid function name '" << tok.val() << "'";
-          throw std::logic_error(ss.str());
+        for (std::size_t i = 0; i < n; ++i) {
+          for (Reg k = 0; k < instr.rhs; ++k) args[k] = regs[operands[k]][i];
+          dst[i] = instr.fn.nary(args.data());
         }
       } break;
+    }
+  }
+}
 
-      default:
-        std::stringstream ss;
-        ss << "invalid token '" << tok << "'";
-        throw std::logic_error(ss.str());
-        break;
+// Post-order walk with an explicit stack: left-associative chains make the
+// tree as deep as the expression is long.
+auto s21::SmartCalc::BuildDag_(const AstNode* root, ExprDag& dag) const
+    -> ExprDag::NodeId {
+  using Node = ExprDag::Node;
+
+  std::vector<ExprDag::NodeId> stack;
+  std::vector<std::pair<const AstNode*, std::uint32_t>> walk{{root, 0}};
+
+  auto pop = [&stack]() {
+    auto id = stack.back();
+    stack.pop_back();
+    return id;
+  };
+
+  // Operations on literals only are folded with the interpreter's own
+  // arithmetic, so the folded value is bit-identical to evaluating it.
+  auto push = [&](Node node) {
+    std::array<double, FunctionRegistry::kMaxArity> args{};
+    bool literal = true;
+
+    for (std::size_t i = 0; i < node.arity(); ++i) {
+      literal = literal && dag[node.args[i]].IsNumber();
+      args[i] = dag[node.args[i]].value;
+    }
+
+    if (literal) {
+      auto op = CompiledExpression::ToOp_(node);
+      auto fn = CompiledExpression::ToCallee_(node.fn);
+      node = {Token::Kind::Number, {}, nullptr,
+              op == CompiledExpression::Op::CallN
+                  ? fn.nary(args.data())
+                  : CompiledExpression::Apply_(op, args[0], args[1], fn)};
+    }
+
+    stack.push_back(dag.Add(node));
+  };
+
+  while (!walk.empty()) {
+    auto ast = walk.back().first;
+    auto& next = walk.back().second;
+
+    if (next < ast->arity) {
+      auto child = ast->args[next++];
+      walk.emplace_back(child, 0);
+      continue;
+    }
+
+    walk.pop_back();
+
+    if (ast->kind == Token::Kind::Number) {
+      stack.push_back(dag.Add({ast->kind, {}, nullptr, ast->value}));
+    } else if (ast->kind == Token::Kind::Variable) {
+      Node node{ast->kind};
+      node.slot = ast->slot;
+      stack.push_back(dag.Add(node));
+    } else {
+      Node node{ast->kind, {}, ast->fn};
+      for (auto i = ast->arity; i-- > 0;) node.args[i] = pop();
+      push(node);
     }
   }
 
   return stack.back();
 }
 
-void s21::SmartCalc::Clear_() {
-  ca_.clear();
-  tx_.clear();
+void s21::SmartCalc::RegisterFunction(std::string_view name, MathFn fn,
+                                      BatchFn batch) {
+  functions_.Register(name, fn, batch);
 }
 
-void s21::SmartCalc::Parse_(std::string_view expr) {
-  Lexer lexer(expr);
+void s21::SmartCalc::RegisterFunction(std::string_view name, BinaryFn fn) {
+  functions_.Register(name, fn);
+}
 
-  for (auto& t : lexer.Collect()) {
-    if (t.IsNumber())
-      ca_.push_back(t);
-    else if (t.IsIdent())
-      HandleIdent_(t);
-    else if (t.IsOpenBrace())
-      tx_.push_back(t);
-    else if (t.IsCloseBrace())
-      HandleCloseBrace_();
-    else if (t.IsOperator())
-      HandleOperator_(t);
-    else if (t == Token::Whitespace())
-      continue;
-    else {
-      std::stringstream ss;
-      ss << "invalid token '" << t << "'";
-      throw std::logic_error(ss.str());
-    }
-  }
+void s21::SmartCalc::RegisterFunction(std::string_view name,
+                                      std::size_t arity, NaryFn fn) {
+  functions_.Register(name, arity, fn);
+}
 
-  while (tx_.size()) {
-    ca_.push_back(tx_.back());
-    tx_.pop_back();
-  }
+void s21::SmartCalc::RegisterInterval(std::string_view name, IntervalFn fn) {
+  functions_.SetInterval(name, fn);
 }
 
-void s21::SmartCalc::HandleCloseBrace_() {
-  while (!tx_.empty()) {
-    if (tx_.back() == Token::OpenBrace()) {
-      tx_.pop_back();
-      break;
-    }
-    ca_.push_back(tx_.back());
-    tx_.pop_back();
+s21::FunctionRegistry::FunctionRegistry() {
+  for (auto& entry : kMathFunctions) Register(entry.name, entry.fn);
+
+  Register("pow", static_cast<BinaryFn>(std::pow));
+  Register("atan2", static_cast<BinaryFn>(std::atan2));
+  Register("hypot", static_cast<BinaryFn>(std::hypot));
+  Register("min", static_cast<BinaryFn>(std::fmin));
+  Register("max", static_cast<BinaryFn>(std::fmax));
+  Register("clamp", 3, [](const double* args) {
+    return std::fmin(std::fmax(args[0], args[1]), args[2]);
+  });
+
+  SetInterval("cos", Unary<interval::Cos>);
+  SetInterval("sin", Unary<interval::Sin>);
+  SetInterval("tan", Unary<interval::Tan>);
+  SetInterval("acos", Unary<interval::Acos>);
+  SetInterval("asin", Unary<interval::Asin>);
+  SetInterval("atan", Unary<interval::Atan>);
+  SetInterval("sqrt", Unary<interval::Sqrt>);
+  SetInterval("ln", Unary<interval::Log10>);
+  SetInterval("log", Unary<interval::Log>);
+  SetInterval("pow", Binary<interval::Pow>);
+  SetInterval("atan2", Binary<interval::Atan2>);
+  SetInterval("hypot", Binary<interval::Hypot>);
+  SetInterval("min", Binary<interval::Min>);
+  SetInterval("max", Binary<interval::Max>);
+  SetInterval("clamp", [](const Interval* args) {
+    return interval::Min(interval::Max(args[0], args[1]), args[2]);
+  });
+
+  for (auto& entry : entries_) entry.builtin = true;
+}
+
+void s21::FunctionRegistry::Register(std::string_view name, MathFn fn,
+                                     BatchFn batch) {
+  Add_({std::string(name), 1, fn, nullptr, nullptr, fn ? batch : nullptr});
+}
+
+void s21::FunctionRegistry::Register(std::string_view name, BinaryFn fn) {
+  Add_({std::string(name), 2, nullptr, fn});
+}
+
+void s21::FunctionRegistry::Register(std::string_view name,
+                                     std::size_t arity, NaryFn fn) {
+  if (arity < 1 || arity > kMaxArity) fn = nullptr;
+  Add_({std::string(name), arity, nullptr, nullptr, fn});
+}
+
+void s21::FunctionRegistry::SetInterval(std::string_view name,
+                                        IntervalFn fn) {
+  auto it = ids_.find(std::string(name));
+
+  if (it == ids_.end()) {
+    std::stringstream ss;
+    ss << "unknown function '" << name << "'";
+    throw std::invalid_argument(ss.str());
   }
+
+  entries_[it->second].interval = fn;
 }
 
-void s21::SmartCalc::HandleIdent_(const Token& tok) {
-  if (ResolveMathFnName_(tok.val()) != nullptr)
-    tx_.emplace_back(Token::Function(tok.val()));
-  else if (tok.val() == "x")
-    ca_.emplace_back(Token::Variable(tok.val()));
+void s21::FunctionRegistry::Add_(Entry entry) {
+  Lexer lexer(entry.name);
+  bool callable = entry.fn || entry.binary || entry.nary;
+
+  if (!callable || lexer.Next() != Token::Ident(entry.name) ||
+      entry.name == "x") {
+    std::stringstream ss;
+    ss << "cannot register function '" << entry.name << "'";
+    throw std::invalid_argument(ss.str());
+  }
+
+  auto [it, inserted] = ids_.try_emplace(entry.name, Id(size()));
+  if (inserted)
+    entries_.push_back(std::move(entry));
   else
-    ca_.emplace_back(Token::Invalid(tok.val()));
+    entries_[it->second] = std::move(entry);
 }
 
-void s21::SmartCalc::HandleOperator_(const Token& tok) {
-  if (tx_.size() != 0) {
-    auto& tx_back = tx_.back();
-    if (tx_back.kind() >= tok.kind()) {
-      ca_.push_back(tx_back);
-      tx_.pop_back();
+auto s21::FunctionRegistry::Find(std::string_view name) const
+    -> const Entry* {
+  auto it = ids_.find(std::string(name));
+  return it != ids_.end() ? &entries_[it->second] : nullptr;
+}
 
-      if (tx_back.kind() == Token::Kind::Function && tx_.size() > 0 &&
-          tx_.back() == Token::Negate()) {
-        ca_.push_back(tx_.back());
-        tx_.pop_back();
-      }
-    }
+auto s21::ExprDag::Add(const Node& node) -> NodeId {
+  auto [it, inserted] = index_.try_emplace(node, NodeId(nodes_.size()));
+  if (inserted) nodes_.push_back(node);
+  return it->second;
+}
+
+auto s21::ExprDag::Node::operator==(const Node& other) const -> bool {
+  return kind == other.kind && args == other.args && fn == other.fn &&
+         slot == other.slot &&
+         std::memcmp(&value, &other.value, sizeof(value)) == 0;
+}
+
+auto s21::ExprDag::Node::arity() const -> std::size_t {
+  switch (kind) {
+    case Token::Kind::Number:
+    case Token::Kind::Variable:
+      return 0;
+    case Token::Kind::Negate:
+      return 1;
+    case Token::Kind::Function:
+      return fn->arity;
+    default:
+      return 2;
   }
-  tx_.push_back(tok);
-}
-
-constexpr auto s21::SmartCalc::ResolveMathFnName_(std::string_view name)
-    -> s21::SmartCalc::MathFn {
-  if (name.size() == 0) return nullptr;
-  MathFn ptr = nullptr;
-
-  if (name == "cos")
-    ptr = std::cos;
-  else if (name == "sin")
-    ptr = std::sin;
-  else if (name == "tan")
-    ptr = std::tan;
-  else if (name == "acos")
-    ptr = std::acos;
-  else if (name == "asin")
-    ptr = std::asin;
-  else if (name == "atan")
-    ptr = std::atan;
-  else if (name == "sqrt")
-    ptr = std::sqrt;
-  else if (name == "ln")
-    ptr = std::log10;
-  else if (name == "log")
-    ptr = std::log;
-
-  return ptr;
+}
+
+auto s21::ExprDag::NodeHash::operator()(const Node& node) const
+    -> std::size_t {
+  std::uint64_t bits;
+  std::memcpy(&bits, &node.value, sizeof(bits));
+
+  std::size_t seed = std::hash<int>()(static_cast<int>(node.kind));
+  auto mix = [&seed](std::size_t v) {
+    seed ^= v + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+  };
+
+  for (auto arg : node.args) mix(arg);
+  mix(std::hash<const void*>()(node.fn));
+  mix(std::size_t(bits));
+  mix(node.slot);
+
+  return seed;
 }
 
 auto s21::CreditCalc::Evaluate(const Term& term, CreditType type) const
@@ -391,9 +861,8 @@ auto s21::CreditCalc::CalcAnnual(const Term& term) const -> Result {
       break;
   }
 
-  double m_payment =
-      term.credit_amount *
-      (interest_rate / (1 - pow(1 + interest_rate, -term_in_months)));
+  double m_payment = static_expr<kAnnuityPayment>::Evaluate(
+      term.credit_amount, interest_rate, term_in_months);
   double o_payment = (m_payment * term_in_months) - term.credit_amount;
   double t_payment = term.credit_amount + o_payment;
 
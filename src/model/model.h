@@ -2,12 +2,21 @@
 #define SMART_CALC_V2_MODEL_MODEL_H_
 
 #include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <ostream>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "interval.h"
+#include "simd.h"
+
 namespace s21 {
 constexpr double EPS = 0.01;
 
@@ -33,6 +42,7 @@ class Token {
     Negate,
     Function,
     Ident,
+    Comma,
   };
 
  public:
@@ -90,6 +100,7 @@ class Token {
   static constexpr auto ModOp() { return Token(Kind::ModOp); }
   static constexpr auto ExpOp() { return Token(Kind::ExpOp); }
   static constexpr auto Negate() { return Token(Kind::Negate); }
+  static constexpr auto Comma() { return Token(Kind::Comma); }
 
  public:
   constexpr auto kind() const { return kind_; }
@@ -97,12 +108,19 @@ class Token {
   auto c_str() const -> const char*;
 
  public:
-  auto IsOperator() const -> bool;
+  constexpr auto IsOperator() const {
+    return kind_ == Kind::Negate || kind_ == Kind::PlusOp ||
+           kind_ == Kind::MinusOp || kind_ == Kind::MulOp ||
+           kind_ == Kind::DivOp || kind_ == Kind::ModOp ||
+           kind_ == Kind::ExpOp;
+  }
+
   constexpr auto IsIdent() const { return kind_ == Kind::Ident; }
   constexpr auto IsNumber() const { return kind_ == Kind::Number; }
   constexpr auto IsOpenBrace() const { return kind_ == Kind::OpenBrace; }
 
   constexpr auto IsCloseBrace() const { return kind_ == Kind::CloseBrace; }
+  constexpr auto IsComma() const { return kind_ == Kind::Comma; }
 
  private:
   Kind kind_{Kind::Invalid};
@@ -111,49 +129,444 @@ class Token {
 
 std::ostream& operator<<(std::ostream& s, const Token& t);
 
+namespace lexer_detail {
+enum CharClass : std::uint8_t {
+  kSpace = 1,
+  kDigit = 2,
+  kAlpha = 4,
+  kOperator = 8,
+};
+
+constexpr auto MakeCharClasses() {
+  std::array<std::uint8_t, 256> table{};
+
+  for (int c = '\t'; c <= '\r'; ++c) table[c] = kSpace;
+  table[' '] = kSpace;
+  for (int c = '0'; c <= '9'; ++c) table[c] = kDigit;
+  for (int c = 'a'; c <= 'z'; ++c) table[c] = kAlpha;
+  for (int c = 'A'; c <= 'Z'; ++c) table[c] = kAlpha;
+  for (char c : {'+', '-', '*', '/', '%', '^', '(', ')', ','})
+    table[static_cast<unsigned char>(c)] = kOperator;
+
+  return table;
+}
+
+// ASCII only, independent of the C locale.
+inline constexpr auto kCharClasses = MakeCharClasses();
+}  // namespace lexer_detail
+
 class Lexer {
  public:
-  Lexer() = default;
-  Lexer(std::string_view expr)
+  constexpr Lexer() = default;
+  constexpr Lexer(std::string_view expr)
       : expr_(expr), it_(expr.cbegin()), end_(expr.cend()) {}
   ~Lexer() = default;
 
  public:
-  auto Next() -> Token;
+  constexpr auto Next() -> Token;
   auto Collect() -> std::vector<Token>;
 
  private:
-  auto Digit_() -> Token;
-  auto Operator_() -> Token;
-  auto Ident_() -> Token;
+  constexpr auto Digit_() -> Token;
+  constexpr auto Operator_() -> Token;
+  constexpr auto Ident_() -> Token;
+  constexpr void Skip_(std::uint8_t classes);
+
+ private:
+  static constexpr auto Class_(char c) {
+    return lexer_detail::kCharClasses[static_cast<unsigned char>(c)];
+  }
+  static constexpr auto IsDigit_(char c) {
+    return Class_(c) == lexer_detail::kDigit;
+  }
+  static constexpr auto IsAlpha_(char c) {
+    return Class_(c) == lexer_detail::kAlpha;
+  }
+  static constexpr auto IsOperator_(char c) {
+    return Class_(c) == lexer_detail::kOperator;
+  }
 
  private:
   std::string_view expr_;
-  std::string_view::const_iterator it_;
-  std::string_view::const_iterator end_;
+  std::string_view::const_iterator it_{};
+  std::string_view::const_iterator end_{};
   Token prev_{Token::Kind::StartStream};
 };
 
-class SmartCalc {
+constexpr auto Lexer::Next() -> Token {
+  Token t;
+
+  Skip_(lexer_detail::kSpace);
+  if (it_ == end_) return Token::EndStream();
+
+  if (IsDigit_(*it_))
+    t = Digit_();
+  else if (IsOperator_(*it_))
+    t = Operator_();
+  else if (IsAlpha_(*it_))
+    t = Ident_();
+  else
+    t = Token::Invalid({it_++, 1});
+
+  prev_ = t;
+
+  return t;
+}
+
+constexpr auto Lexer::Digit_() -> Token {
+  auto start = it_;
+
+  Skip_(lexer_detail::kDigit);
+  if (it_ != end_ && *it_ == '.') {
+    ++it_;
+    Skip_(lexer_detail::kDigit);
+  }
+
+  return Token::Number({start, std::size_t(it_ - start)});
+}
+
+constexpr auto Lexer::Operator_() -> Token {
+  switch (*(it_++)) {
+    case '+': {
+      if (prev_ == Token::StartStream() || prev_.IsOperator() ||
+          prev_.IsComma())
+        return Token::Whitespace();
+      return Token::PlusOp();
+    }
+    case '-': {
+      if (prev_ == Token::StartStream() ||
+          prev_.IsOperator() || prev_.IsOpenBrace() || prev_.IsComma())
+        return Token::Negate();
+      return Token::MinusOp();
+    }
+    case '*': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::MulOp();
+    }
+    case '/': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::DivOp();
+    }
+    case '%': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::ModOp();
+    }
+    case '^': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::ExpOp();
+    }
+    case '(':
+      return Token::OpenBrace();
+    case ')': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::CloseBrace();
+    }
+    case ',': {
+      if (prev_ == Token::StartStream()) return Token();
+      return Token::Comma();
+    }
+    default:
+      return Token::Invalid({it_ - 1, 1});
+  }
+}
+
+constexpr auto Lexer::Ident_() -> Token {
+  auto start = it_;
+  Skip_(lexer_detail::kAlpha | lexer_detail::kDigit);
+  return Token::Ident({start, std::size_t(it_ - start)});
+}
+
+// Advances past a run of characters in the given classes. At runtime long
+// runs are skipped 16 bytes at a time; constant evaluation and the final
+// partial block use the table.
+constexpr void Lexer::Skip_(std::uint8_t classes) {
+#if defined(__SSE2__) && defined(__GNUC__)
+  if (!__builtin_is_constant_evaluated() && end_ - it_ >= 16) {
+    const char* p = &*it_;
+    const char* end = p + (end_ - it_);
+
+    if (classes == lexer_detail::kSpace)
+      it_ += simd::text::SkipSpaces(p, end) - p;
+    else if (classes == lexer_detail::kDigit)
+      it_ += simd::text::SkipDigits(p, end) - p;
+    else
+      it_ += simd::text::SkipAlnum(p, end) - p;
+  }
+#endif
+
+  while (it_ != end_ && (Class_(*it_) & classes) != 0) ++it_;
+}
+
+struct MathFunction {
+  std::string_view name;
+  double (*fn)(double);
+};
+
+inline constexpr std::array<MathFunction, 9> kMathFunctions{{
+    {"cos", std::cos},
+    {"sin", std::sin},
+    {"tan", std::tan},
+    {"acos", std::acos},
+    {"asin", std::asin},
+    {"atan", std::atan},
+    {"sqrt", std::sqrt},
+    {"ln", std::log10},
+    {"log", std::log},
+}};
+
+// Functions callable from expressions, keyed by interned name. Lookups only
+// happen while compiling; programs keep the resolved pointers. Functions must
+// be pure, since calls on literals are folded and repeated calls are shared.
+// A batch variant maps n inputs to n outputs and must allow in == out.
+// Every function has a fixed arity: unary and binary functions are called
+// directly, wider ones receive their arguments as an array. An interval
+// variant bounds the function over ranges of its arguments; without one,
+// interval evaluation assumes the function may return anything.
+class FunctionRegistry {
  public:
+  using Id = std::uint32_t;
   using MathFn = double (*)(double);
+  using BinaryFn = double (*)(double, double);
+  using NaryFn = double (*)(const double*);
+  using BatchFn = void (*)(const double*, double*, std::size_t);
+  using IntervalFn = Interval (*)(const Interval*);
+
+  static constexpr std::size_t kMaxArity = 8;
+
+  struct Entry {
+    std::string name;
+    std::size_t arity{1};
+    MathFn fn{nullptr};
+    BinaryFn binary{nullptr};
+    NaryFn nary{nullptr};
+    BatchFn batch{nullptr};
+    IntervalFn interval{nullptr};
+    // Set for the functions the registry starts with, which never throw.
+    bool builtin{false};
+  };
+
+ public:
+  FunctionRegistry();
 
  public:
-  auto Evaluate(std::string_view, double = 0.0f) -> double;
+  void Register(std::string_view name, MathFn fn, BatchFn batch = nullptr);
+  void Register(std::string_view name, BinaryFn fn);
+  void Register(std::string_view name, std::size_t arity, NaryFn fn);
+  void SetInterval(std::string_view name, IntervalFn fn);
+  auto Find(std::string_view name) const -> const Entry*;
+  auto size() const { return entries_.size(); }
+
+ private:
+  void Add_(Entry entry);
+
+ private:
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, Id> ids_;
+};
+
+class CompiledExpression;
+class ExprDag;
+struct AstNode;
+
+struct PhaseStats {
+  std::uint64_t calls{0};
+  std::uint64_t nanoseconds{0};
+};
+
+// Process-wide counters, collected only when built with SMARTCALC_STATS.
+// Each Compile makes one lexing pass, timed as lex; parse is the rest of
+// the front end, building the syntax tree and lowering it. tokens counts
+// the tokens lexed. max_frame is the most registers (variables, constants
+// and temporaries) any compiled program evaluates in.
+struct EngineStats {
+  PhaseStats lex;
+  PhaseStats parse;
+  PhaseStats compile;
+  PhaseStats evaluate;
+  std::uint64_t tokens{0};
+  std::uint64_t values{0};
+  std::uint64_t max_frame{0};
+};
+
+// Compile and the Evaluate helpers keep their parse state on the stack or in
+// thread-local buffers, so one instance may compile from any number of
+// threads at once. The function registry is the only shared state:
+// RegisterFunction must not run concurrently with anything else on the same
+// instance.
+class SmartCalc {
+ public:
+  using MathFn = FunctionRegistry::MathFn;
+  using BinaryFn = FunctionRegistry::BinaryFn;
+  using NaryFn = FunctionRegistry::NaryFn;
+  using BatchFn = FunctionRegistry::BatchFn;
+  using IntervalFn = FunctionRegistry::IntervalFn;
+
+  // Variable names in slot order; a compiled expression takes its values
+  // as an array indexed the same way.
+  using Variables = std::vector<std::string>;
+
+  // Jit leaves expressions that call registered functions interpreted:
+  // the generated code has no unwind info, so they must not throw
+  // through it.
+  enum class Tier {
+    Interpreter,
+    Jit,
+  };
+
+ public:
+  auto Compile(std::string_view, Tier = Tier::Interpreter) const
+      -> CompiledExpression;
+  auto Compile(std::string_view, const Variables&,
+               Tier = Tier::Interpreter) const -> CompiledExpression;
+  auto Evaluate(std::string_view, double = 0.0f) const -> double;
+  void EvaluateBatch(std::string_view, const double*, double*,
+                     std::size_t) const;
+  auto EvaluateInterval(std::string_view, Interval) const -> Interval;
+
+  void RegisterFunction(std::string_view, MathFn, BatchFn = nullptr);
+  void RegisterFunction(std::string_view, BinaryFn);
+  void RegisterFunction(std::string_view, std::size_t, NaryFn);
+  void RegisterInterval(std::string_view, IntervalFn);
+  auto Functions() const -> const FunctionRegistry& { return functions_; }
+
+#ifdef SMARTCALC_STATS
+  static constexpr bool kStatsEnabled = true;
+#else
+  static constexpr bool kStatsEnabled = false;
+#endif
+
+  static auto Stats() -> EngineStats;
+  static void ResetStats();
+
+ private:
+  auto BuildDag_(const AstNode*, ExprDag&) const -> std::uint32_t;
+
+ private:
+  FunctionRegistry functions_;
+};
+
+class ExprDag {
+ public:
+  using NodeId = std::uint32_t;
+
+  struct Node {
+    Token::Kind kind;
+    std::array<NodeId, FunctionRegistry::kMaxArity> args{};
+    const FunctionRegistry::Entry* fn{nullptr};
+    double value{0};
+    NodeId slot{0};
+
+    auto operator==(const Node& other) const -> bool;
+    auto arity() const -> std::size_t;
+    constexpr auto IsNumber() const { return kind == Token::Kind::Number; }
+  };
+
+ public:
+  auto Add(const Node&) -> NodeId;
+  auto operator[](NodeId id) const -> const Node& { return nodes_[id]; }
+  auto size() const { return nodes_.size(); }
+
+ private:
+  struct NodeHash {
+    auto operator()(const Node&) const -> std::size_t;
+  };
+
+ private:
+  std::vector<Node> nodes_;
+  std::unordered_map<Node, NodeId, NodeHash> index_;
+};
+
+// Immutable once compiled: every const member may be called from any number
+// of threads at once. Copies share the JIT code, which is read-only.
+class CompiledExpression {
+ public:
+  // The constant 0: a single register and no instructions.
+  CompiledExpression() : frame_(1, 0.0) {}
+  CompiledExpression(const CompiledExpression&) = default;
+  CompiledExpression(CompiledExpression&&) noexcept = default;
+  ~CompiledExpression() = default;
+
+ public:
+  auto operator=(const CompiledExpression&) -> CompiledExpression& = default;
+  auto operator=(CompiledExpression&&) noexcept
+      -> CompiledExpression& = default;
+
+ public:
+  // The single-value forms bind the first variable. The array forms bind
+  // the first n variables in slot order; the remaining ones are zero.
+  auto Evaluate(double = 0.0) const -> double;
+  auto Evaluate(const double*, std::size_t) const -> double;
+  void EvaluateBatch(const double*, double*, std::size_t) const;
+  void EvaluateBatch(const double* const*, std::size_t, double*,
+                     std::size_t) const;
+
+  // Bounds on every value Evaluate can return for arguments in the given
+  // ranges, bound the same way. Always interpreted, even when native.
+  auto EvaluateInterval(Interval) const -> Interval;
+  auto EvaluateInterval(const Interval*, std::size_t) const -> Interval;
+  auto arity() const { return std::size_t(vars_); }
+  auto IsNative() const { return native_ != nullptr; }
+
+ private:
+  friend class SmartCalc;
+
+  using Reg = std::uint32_t;
+  using NativeFn = double (*)(double*);
+
+  // Frames up to this many registers are evaluated in a stack buffer,
+  // larger ones in a buffer kept per thread.
+  static constexpr std::size_t kInlineFrame = 64;
+
+  enum class Op : std::uint8_t {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Pow,
+    Neg,
+    Call,
+    Call2,
+    CallN,
+  };
+
+  union Callee {
+    SmartCalc::MathFn unary;
+    SmartCalc::BinaryFn binary;
+    SmartCalc::NaryFn nary;
+  };
+
+  // CallN reads its operands from args_[lhs, lhs + rhs).
+  struct Instr {
+    Op op;
+    Reg dst;
+    Reg lhs;
+    Reg rhs{0};
+    Callee fn{nullptr};
+    SmartCalc::BatchFn batch{nullptr};
+  };
 
  private:
-  void Clear_();
-  void Parse_(std::string_view);
+  CompiledExpression(const ExprDag&, ExprDag::NodeId, std::size_t);
 
  private:
-  void HandleCloseBrace_();
-  void HandleIdent_(const Token&);
-  void HandleOperator_(const Token&);
-  static constexpr auto ResolveMathFnName_(std::string_view) -> MathFn;
+  static auto ToOp_(const ExprDag::Node&) -> Op;
+  static auto ToCallee_(const FunctionRegistry::Entry*) -> Callee;
+  static auto Apply_(Op, double, double, Callee) -> double;
+  auto Execute_(double*) const -> double;
+  void Run_(double* const*, std::size_t) const;
+  auto Jit_() -> bool;
 
  private:
-  std::vector<Token> ca_;
-  std::vector<Token> tx_;
+  std::vector<Instr> code_;
+  std::vector<FunctionRegistry::IntervalFn> intervals_;
+  std::vector<Reg> args_;
+  std::vector<double> frame_;
+  Reg vars_{0};
+  Reg result_{0};
+  bool calls_registered_{false};
+  std::shared_ptr<void> native_mem_;
+  NativeFn native_{nullptr};
 };
 
 class CreditCalc {
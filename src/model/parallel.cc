@@ -0,0 +1,107 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+using Clock = std::chrono::steady_clock;
+
+static auto SecondsSince(Clock::time_point start) -> double {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+auto s21::ParallelExecutor::Report::Throughput() const -> double {
+  std::size_t values = 0;
+  for (auto& thread : threads) values += thread.values;
+  return seconds > 0 ? values / seconds : 0;
+}
+
+s21::ParallelExecutor::ParallelExecutor(std::size_t threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (std::size_t i = 1; i < threads; ++i)
+    workers_.emplace_back(&ParallelExecutor::Work_, this, i);
+}
+
+s21::ParallelExecutor::~ParallelExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  wake_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+auto s21::ParallelExecutor::Run(const CompiledExpression& expr,
+                                const double* xs, double* out, std::size_t n)
+    -> Report {
+  std::lock_guard<std::mutex> run(run_mutex_);
+  auto start = Clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expr_ = &expr;
+    xs_ = xs;
+    out_ = out;
+    n_ = n;
+    next_.store(0, std::memory_order_relaxed);
+    stats_.assign(size(), {});
+    error_ = nullptr;
+    busy_ = workers_.size();
+    ++generation_;
+  }
+
+  wake_.notify_all();
+  Drain_(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0; });
+  if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+
+  return {stats_, SecondsSince(start)};
+}
+
+void s21::ParallelExecutor::Work_(std::size_t index) {
+  std::size_t seen = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+
+    Drain_(index);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_ == 0) done_.notify_one();
+  }
+}
+
+void s21::ParallelExecutor::Drain_(std::size_t index) {
+  auto start = Clock::now();
+  ThreadStats stats;
+
+  for (;;) {
+    auto begin = next_.fetch_add(kChunk, std::memory_order_relaxed);
+    if (begin >= n_) break;
+
+    auto len = std::min(kChunk, n_ - begin);
+    try {
+      expr_->EvaluateBatch(xs_ + begin, out_ + begin, len);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+      next_.store(n_, std::memory_order_relaxed);
+      break;
+    }
+
+    stats.values += len;
+    ++stats.chunks;
+  }
+
+  stats.seconds = SecondsSince(start);
+  stats_[index] = stats;
+}
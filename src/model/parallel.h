@@ -0,0 +1,82 @@
+#ifndef SMART_CALC_V2_MODEL_PARALLEL_H_
+#define SMART_CALC_V2_MODEL_PARALLEL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "model.h"
+
+namespace s21 {
+// Fixed pool that evaluates one compiled expression over a large array.
+// Threads claim chunks of kChunk values from a shared counter, so faster
+// threads simply take more of them. The calling thread works as thread 0.
+// Run calls are serialized. If a chunk throws, the others stop claiming
+// work and Run rethrows the first exception once every thread is idle.
+class ParallelExecutor {
+ public:
+  // Input and output of a chunk (256 KiB together) stay in L2.
+  static constexpr std::size_t kChunk = 16384;
+
+  struct ThreadStats {
+    std::size_t values{0};
+    std::size_t chunks{0};
+    double seconds{0};
+
+    auto Throughput() const -> double {
+      return seconds > 0 ? values / seconds : 0;
+    }
+  };
+
+  struct Report {
+    std::vector<ThreadStats> threads;
+    double seconds{0};
+
+    auto Throughput() const -> double;
+  };
+
+ public:
+  // Zero threads means one per hardware thread.
+  explicit ParallelExecutor(std::size_t threads = 0);
+  ParallelExecutor(const ParallelExecutor&) = delete;
+  ParallelExecutor(ParallelExecutor&&) = delete;
+  ~ParallelExecutor();
+
+ public:
+  auto operator=(const ParallelExecutor&) -> ParallelExecutor& = delete;
+  auto operator=(ParallelExecutor&&) -> ParallelExecutor& = delete;
+
+ public:
+  auto Run(const CompiledExpression&, const double*, double*, std::size_t)
+      -> Report;
+  auto size() const { return workers_.size() + 1; }
+
+ private:
+  void Work_(std::size_t index);
+  void Drain_(std::size_t index);
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::size_t generation_{0};
+  std::size_t busy_{0};
+  bool stop_{false};
+
+  const CompiledExpression* expr_{nullptr};
+  const double* xs_{nullptr};
+  double* out_{nullptr};
+  std::size_t n_{0};
+  std::atomic<std::size_t> next_{0};
+  std::vector<ThreadStats> stats_;
+  std::exception_ptr error_;
+};
+}  // namespace s21
+
+#endif  // SMART_CALC_V2_MODEL_PARALLEL_H_
@@ -0,0 +1,250 @@
+#include "parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "decimal.h"
+
+using s21::Token;
+
+// Locale-independent and bounded by the token, unlike atof. Literals are
+// plain decimals, so the only failure is a magnitude outside double range.
+static auto ParseNumber(std::string_view digits) -> double {
+  double value = 0;
+  auto [ptr, ec] = s21::decimal::FromChars(
+      digits.data(), digits.data() + digits.size(), value);
+
+  if (ec == std::errc::result_out_of_range) {
+    auto first = digits.find_first_not_of("0.");
+    bool overflow = first != digits.npos && first < digits.find('.');
+    value = overflow ? HUGE_VAL : 0.0;
+  }
+
+  return value;
+}
+
+// Zero ends an expression: anything that is not a binary operator.
+static auto BindingPower(Token::Kind kind) -> int {
+  switch (kind) {
+    case Token::Kind::PlusOp:
+    case Token::Kind::MinusOp:
+      return 1;
+    case Token::Kind::MulOp:
+    case Token::Kind::DivOp:
+    case Token::Kind::ModOp:
+      return 2;
+    case Token::Kind::ExpOp:
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+auto s21::Arena::Allocate_(std::size_t size, std::size_t align) -> void* {
+  offset_ = (offset_ + align - 1) & ~(align - 1);
+
+  if (used_blocks_ == 0 || offset_ + size > kBlockSize) {
+    if (used_blocks_ == blocks_.size())
+      blocks_.emplace_back(new std::byte[kBlockSize]);
+    ++used_blocks_;
+    offset_ = 0;
+  }
+
+  void* ptr = blocks_[used_blocks_ - 1].get() + offset_;
+  offset_ += size;
+  return ptr;
+}
+
+// The whole input is lexed in one pass, into a buffer each thread reuses,
+// before parsing starts.
+auto s21::Parser::Parse(std::string_view expr) -> const AstNode* {
+  thread_local std::vector<Token> buffer;
+  Lexer lexer(expr);
+
+#ifdef SMARTCALC_STATS
+  auto start = std::chrono::steady_clock::now();
+#endif
+
+  buffer.clear();
+  tokens_ = 0;
+
+  for (auto tok = lexer.Next(); tok != Token::EndStream();
+       tok = lexer.Next()) {
+    ++tokens_;
+    // A unary '+' lexes as whitespace.
+    if (tok != Token::Whitespace()) buffer.push_back(tok);
+  }
+  buffer.push_back(Token::EndStream());
+
+#ifdef SMARTCALC_STATS
+  lex_nanoseconds_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+#endif
+
+  next_ = buffer.data();
+  depth_ = 0;
+
+  Advance_();
+  if (tok_ == Token::EndStream())
+    throw std::invalid_argument("empty expression");
+
+  auto root = Expression_(0);
+  if (tok_ != Token::EndStream()) Unexpected_();
+
+  return root;
+}
+
+auto s21::Parser::Expression_(int min_power) -> const AstNode* {
+  auto lhs = Operand_();
+
+  for (auto power = BindingPower(tok_.kind()); power > min_power;
+       power = BindingPower(tok_.kind())) {
+    auto kind = tok_.kind();
+    Advance_();
+
+    auto args = arena_.NewArray<const AstNode*>(2);
+    args[0] = lhs;
+    args[1] = Expression_(power);
+    lhs = Node_({kind, 2, args});
+  }
+
+  return lhs;
+}
+
+// Unary signs apply to the operand alone, so they bind tighter than ^. A
+// '+' or '-' in operand position is a sign whatever the lexer called it.
+auto s21::Parser::Operand_() -> const AstNode* {
+  if (++depth_ > kMaxDepth)
+    throw std::invalid_argument("expression is nested too deeply");
+
+  const AstNode* node = nullptr;
+
+  switch (tok_.kind()) {
+    case Token::Kind::Number:
+      node = Node_({Token::Kind::Number, 0, nullptr, nullptr,
+                    ParseNumber(tok_.val())});
+      Advance_();
+      break;
+
+    case Token::Kind::Ident:
+      if (auto fn = functions_.Find(tok_.val()))
+        node = Call_(fn);
+      else
+        node = Variable_();
+      break;
+
+    case Token::Kind::OpenBrace:
+      Advance_();
+      node = Expression_(0);
+      Expect_(Token::Kind::CloseBrace);
+      break;
+
+    case Token::Kind::Negate:
+    case Token::Kind::MinusOp: {
+      Advance_();
+      auto args = arena_.NewArray<const AstNode*>(1);
+      args[0] = Operand_();
+      node = Node_({Token::Kind::Negate, 1, args});
+    } break;
+
+    case Token::Kind::PlusOp:
+      Advance_();
+      node = Operand_();
+      break;
+
+    default:
+      Unexpected_();
+  }
+
+  --depth_;
+  return node;
+}
+
+auto s21::Parser::Call_(const FunctionRegistry::Entry* fn) -> const AstNode* {
+  auto name = tok_.val();
+  Advance_();
+
+  if (tok_.kind() != Token::Kind::OpenBrace) {
+    std::stringstream ss;
+    ss << "expected '(' after function '" << name << "'";
+    throw std::invalid_argument(ss.str());
+  }
+  Advance_();
+
+  auto args = arena_.NewArray<const AstNode*>(fn->arity);
+  std::size_t argc = 0;
+
+  if (tok_.kind() != Token::Kind::CloseBrace) {
+    for (;;) {
+      auto arg = Expression_(0);
+      if (argc < fn->arity) args[argc] = arg;
+      ++argc;
+
+      if (tok_.kind() != Token::Kind::Comma) break;
+      Advance_();
+    }
+  }
+
+  Expect_(Token::Kind::CloseBrace);
+
+  if (argc != fn->arity) {
+    std::stringstream ss;
+    ss << "function '" << name << "' expects " << fn->arity
+       << (fn->arity == 1 ? " argument" : " arguments");
+    throw std::invalid_argument(ss.str());
+  }
+
+  return Node_({Token::Kind::Function, std::uint32_t(fn->arity), args, fn});
+}
+
+auto s21::Parser::Variable_() -> const AstNode* {
+  auto it = std::find(vars_.begin(), vars_.end(), tok_.val());
+
+  if (it == vars_.end()) {
+    std::stringstream ss;
+    ss << "unknown variable '" << tok_.val() << "'";
+    throw std::logic_error(ss.str());
+  }
+
+  Advance_();
+
+  AstNode node{Token::Kind::Variable};
+  node.slot = std::uint32_t(it - vars_.begin());
+  return Node_(node);
+}
+
+// The buffer ends with EndStream, which is never advanced past.
+void s21::Parser::Advance_() {
+  tok_ = *next_;
+  if (tok_ != Token::EndStream()) ++next_;
+}
+
+void s21::Parser::Expect_(Token::Kind kind) {
+  if (tok_.kind() != kind) Unexpected_();
+  Advance_();
+}
+
+void s21::Parser::Unexpected_() const {
+  std::stringstream ss;
+
+  switch (tok_.kind()) {
+    case Token::Kind::EndStream:
+      throw std::invalid_argument("unexpected end of expression");
+
+    case Token::Kind::Invalid:
+      ss << "invalid token '" << tok_ << "'";
+      throw std::logic_error(ss.str());
+
+    case Token::Kind::Comma:
+      throw std::invalid_argument("unexpected ','");
+
+    default:
+      ss << "unexpected token '" << tok_ << "'";
+      throw std::invalid_argument(ss.str());
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef SMART_CALC_V2_MODEL_PARSER_H_
+#define SMART_CALC_V2_MODEL_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "model.h"
+
+namespace s21 {
+// Bump allocator for the nodes of one parse. Reset keeps the blocks, so a
+// thread that compiles many expressions allocates only while its largest
+// tree still grows. Nothing allocated here is ever destroyed.
+class Arena {
+ public:
+  static constexpr std::size_t kBlockSize = 16384;
+
+ public:
+  template <typename T>
+  auto New(const T& value) -> T* {
+    static_assert(std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    return new (Allocate_(sizeof(T), alignof(T))) T(value);
+  }
+
+  template <typename T>
+  auto NewArray(std::size_t n) -> T* {
+    static_assert(std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    return new (Allocate_(n * sizeof(T), alignof(T))) T[n]();
+  }
+
+  void Reset() {
+    used_blocks_ = 0;
+    offset_ = 0;
+  }
+
+  auto capacity() const { return blocks_.size() * kBlockSize; }
+
+ private:
+  auto Allocate_(std::size_t size, std::size_t align) -> void*;
+
+ private:
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;
+  std::size_t used_blocks_{0};
+  std::size_t offset_{0};
+};
+
+// Kinds are those of the tokens they came from: Number, Variable, the
+// binary operators, Negate and Function. Variables are already resolved
+// to their slot and functions to their registry entry.
+struct AstNode {
+  Token::Kind kind{Token::Kind::Invalid};
+  std::uint32_t arity{0};
+  const AstNode* const* args{nullptr};
+  const FunctionRegistry::Entry* fn{nullptr};
+  double value{0};
+  std::uint32_t slot{0};
+};
+
+// Pratt parser. Binding, loosest first: + and -, then *, / and %, then ^,
+// then unary signs. Binary operators are left-associative, so 2^3^2 is 64
+// and -2^2 is 4, as in spreadsheet formulas. Nesting is limited to
+// kMaxDepth to bound recursion.
+class Parser {
+ public:
+  static constexpr std::size_t kMaxDepth = 1024;
+
+ public:
+  Parser(const FunctionRegistry& functions,
+         const std::vector<std::string>& vars, Arena& arena)
+      : functions_(functions), vars_(vars), arena_(arena) {}
+
+ public:
+  auto Parse(std::string_view expr) -> const AstNode*;
+  auto tokens() const { return tokens_; }
+
+  // Length of the lexing pass, measured only with SMARTCALC_STATS.
+  auto lex_nanoseconds() const { return lex_nanoseconds_; }
+
+ private:
+  auto Expression_(int min_power) -> const AstNode*;
+  auto Operand_() -> const AstNode*;
+  auto Call_(const FunctionRegistry::Entry* fn) -> const AstNode*;
+  auto Variable_() -> const AstNode*;
+  auto Node_(const AstNode& node) -> const AstNode* {
+    return arena_.New(node);
+  }
+
+  void Advance_();
+  void Expect_(Token::Kind kind);
+  [[noreturn]] void Unexpected_() const;
+
+ private:
+  const FunctionRegistry& functions_;
+  const std::vector<std::string>& vars_;
+  Arena& arena_;
+  const Token* next_{nullptr};
+  Token tok_;
+  std::size_t depth_{0};
+  std::size_t tokens_{0};
+  std::uint64_t lex_nanoseconds_{0};
+};
+}  // namespace s21
+
+#endif  // SMART_CALC_V2_MODEL_PARSER_H_
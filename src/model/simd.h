@@ -0,0 +1,111 @@
+#ifndef SMART_CALC_V2_MODEL_SIMD_H_
+#define SMART_CALC_V2_MODEL_SIMD_H_
+
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace s21::simd {
+// Packed is as wide as the target allows: 2 lanes on the x86-64 baseline
+// (SSE2), 4 with AVX and 8 with AVX-512F. See SIMD= in the Makefile.
+struct Scalar {
+  using Reg = double;
+  static constexpr std::size_t kWidth = 1;
+
+  static auto Load(const double* p) -> Reg { return *p; }
+  static void Store(double* p, Reg v) { *p = v; }
+};
+
+#if defined(__AVX512F__)
+struct Packed {
+  using Reg = __m512d;
+  static constexpr std::size_t kWidth = 8;
+
+  static auto Load(const double* p) -> Reg { return _mm512_loadu_pd(p); }
+  static void Store(double* p, Reg v) { _mm512_storeu_pd(p, v); }
+};
+#elif defined(__AVX__)
+struct Packed {
+  using Reg = __m256d;
+  static constexpr std::size_t kWidth = 4;
+
+  static auto Load(const double* p) -> Reg { return _mm256_loadu_pd(p); }
+  static void Store(double* p, Reg v) { _mm256_storeu_pd(p, v); }
+};
+#elif defined(__SSE2__)
+struct Packed {
+  using Reg = __m128d;
+  static constexpr std::size_t kWidth = 2;
+
+  static auto Load(const double* p) -> Reg { return _mm_loadu_pd(p); }
+  static void Store(double* p, Reg v) { _mm_storeu_pd(p, v); }
+};
+#else
+using Packed = Scalar;
+#endif
+
+// Ops are generic lambdas, so the same expression is applied to packed
+// registers (through the GCC/Clang vector operators) and to the scalar tail.
+template <typename Lanes = Packed, typename Op>
+inline void Binary(double* dst, const double* lhs, const double* rhs,
+                   std::size_t n, Op op) {
+  std::size_t i = 0;
+  for (; i + Lanes::kWidth <= n; i += Lanes::kWidth)
+    Lanes::Store(dst + i, op(Lanes::Load(lhs + i), Lanes::Load(rhs + i)));
+  for (; i < n; ++i) dst[i] = op(lhs[i], rhs[i]);
+}
+
+template <typename Lanes = Packed, typename Op>
+inline void Unary(double* dst, const double* val, std::size_t n, Op op) {
+  std::size_t i = 0;
+  for (; i + Lanes::kWidth <= n; i += Lanes::kWidth)
+    Lanes::Store(dst + i, op(Lanes::Load(val + i)));
+  for (; i < n; ++i) dst[i] = op(val[i]);
+}
+
+// Character-run scanners for the lexer: each returns the first position in
+// [p, end) whose byte is not in the class, looking at 16 bytes per step.
+// The caller finishes the last partial block with scalar code.
+#if defined(__SSE2__)
+namespace text {
+inline auto InRange(__m128i v, char lo, char hi) -> __m128i {
+  auto shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+  auto limit = _mm_set1_epi8(static_cast<char>(hi - lo));
+  return _mm_cmpeq_epi8(_mm_min_epu8(shifted, limit), shifted);
+}
+
+template <typename Match>
+inline auto Skip(const char* p, const char* end, Match match) -> const char* {
+  for (; end - p >= 16; p += 16) {
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    auto bits = unsigned(_mm_movemask_epi8(match(block)));
+    if (bits != 0xFFFF) return p + __builtin_ctz(~bits);
+  }
+  return p;
+}
+
+inline auto SkipSpaces(const char* p, const char* end) -> const char* {
+  return Skip(p, end, [](__m128i v) {
+    return _mm_or_si128(InRange(v, '\t', '\r'),
+                        _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+  });
+}
+
+inline auto SkipDigits(const char* p, const char* end) -> const char* {
+  return Skip(p, end, [](__m128i v) { return InRange(v, '0', '9'); });
+}
+
+inline auto SkipAlnum(const char* p, const char* end) -> const char* {
+  return Skip(p, end, [](__m128i v) {
+    return _mm_or_si128(
+        InRange(v, '0', '9'),
+        _mm_or_si128(InRange(v, 'a', 'z'), InRange(v, 'A', 'Z')));
+  });
+}
+}  // namespace text
+#endif
+}  // namespace s21::simd
+
+#endif  // SMART_CALC_V2_MODEL_SIMD_H_
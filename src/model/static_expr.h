@@ -0,0 +1,283 @@
+#ifndef SMART_CALC_V2_MODEL_STATIC_EXPR_H_
+#define SMART_CALC_V2_MODEL_STATIC_EXPR_H_
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "model.h"
+
+namespace s21 {
+namespace static_detail {
+enum class Op {
+  Number,
+  Variable,
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Mod,
+  Pow,
+  Neg,
+  Call,
+};
+
+// Stack machine instruction: binary ops read dst and dst + 1 and write dst.
+struct Instr {
+  Op op{Op::Number};
+  std::size_t dst{0};
+  std::size_t var{0};
+  double value{0};
+  std::size_t fn{0};
+};
+
+template <std::size_t N>
+struct Program {
+  std::array<Instr, N> code{};
+  std::size_t size{0};
+  std::size_t depth{0};
+  std::size_t vars{0};
+  std::size_t result{0};
+};
+
+// One rounding, so correctly rounded like from_chars, only on Clinger's
+// fast path: digits below 2^53 and a scale of at most 10^22. Any other
+// literal is rejected, which is a compile error inside a static_expr.
+constexpr auto ParseNumber(std::string_view digits) -> double {
+  constexpr double kMantissaLimit = 9007199254740992.0;  // 2^53
+  constexpr double kMaxScale = 1e22;
+
+  double mantissa = 0;
+  double scale = 1;
+  bool fraction = false;
+
+  for (char c : digits) {
+    if (c == '.') {
+      fraction = true;
+      continue;
+    }
+    mantissa = mantissa * 10 + (c - '0');
+    if (fraction) scale *= 10;
+
+    if (mantissa >= kMantissaLimit || scale > kMaxScale)
+      throw std::invalid_argument("literal has too many digits");
+  }
+
+  return mantissa / scale;
+}
+
+constexpr auto Precedence(Token::Kind kind) -> int {
+  switch (kind) {
+    case Token::Kind::PlusOp:
+    case Token::Kind::MinusOp:
+      return 1;
+    case Token::Kind::MulOp:
+    case Token::Kind::DivOp:
+    case Token::Kind::ModOp:
+      return 2;
+    case Token::Kind::ExpOp:
+      return 3;
+    default:
+      return 4;
+  }
+}
+
+// Index into kMathFunctions, or its size if there is no such function.
+// Functions are carried by index: comparing libm pointers is not a
+// constant expression under every compiler mode.
+constexpr auto FindFunction(std::string_view name) -> std::size_t {
+  std::size_t i = 0;
+  while (i < kMathFunctions.size() && kMathFunctions[i].name != name) ++i;
+  return i;
+}
+
+// Shunting-yard with the binding rules of s21::Parser, so that a static_expr
+// evaluates exactly like the runtime calculator. Identifiers that are not
+// functions become variables, numbered in order of first appearance.
+template <std::size_t N>
+constexpr auto Compile(std::string_view expr) -> Program<N> {
+  Program<N> prog;
+  std::array<Token, N> tx{};
+  std::array<std::string_view, N> names{};
+  std::size_t top = 0;
+  std::size_t depth = 0;
+
+  auto push = [&](Instr instr) {
+    prog.code[prog.size++] = instr;
+    if (depth > prog.depth) prog.depth = depth;
+  };
+
+  auto emit = [&](const Token& tok) {
+    auto binary = [&](Op op) {
+      if (depth < 2) throw std::invalid_argument("stack underflow");
+      push({op, --depth - 1});
+    };
+
+    switch (tok.kind()) {
+      case Token::Kind::Number:
+        ++depth;
+        push({Op::Number, depth - 1, 0, ParseNumber(tok.val())});
+        break;
+      case Token::Kind::PlusOp:
+        binary(Op::Add);
+        break;
+      case Token::Kind::MinusOp:
+        binary(Op::Sub);
+        break;
+      case Token::Kind::MulOp:
+        binary(Op::Mul);
+        break;
+      case Token::Kind::DivOp:
+        binary(Op::Div);
+        break;
+      case Token::Kind::ModOp:
+        binary(Op::Mod);
+        break;
+      case Token::Kind::ExpOp:
+        binary(Op::Pow);
+        break;
+      case Token::Kind::Negate:
+        if (depth < 1) throw std::invalid_argument("stack underflow");
+        push({Op::Neg, depth - 1});
+        break;
+      case Token::Kind::Function:
+        if (depth < 1) throw std::invalid_argument("stack underflow");
+        push({Op::Call, depth - 1, 0, 0, FindFunction(tok.val())});
+        break;
+      default:
+        throw std::logic_error("invalid token");
+    }
+  };
+
+  auto variable = [&](std::string_view name) {
+    std::size_t var = 0;
+    while (var < prog.vars && names[var] != name) ++var;
+    if (var == prog.vars) names[prog.vars++] = name;
+
+    ++depth;
+    push({Op::Variable, depth - 1, var});
+  };
+
+  // Signs never pop, so they bind tighter than any binary operator that
+  // follows; binary operators pop everything at their level or above.
+  auto handle_operator = [&](const Token& tok) {
+    if (tok != Token::Negate())
+      while (top != 0 && tx[top - 1] != Token::OpenBrace() &&
+             Precedence(tx[top - 1].kind()) >= Precedence(tok.kind()))
+        emit(tx[--top]);
+    tx[top++] = tok;
+  };
+
+  Lexer lexer(expr);
+  for (auto t = lexer.Next(); t != Token::EndStream(); t = lexer.Next()) {
+    if (t.IsNumber()) {
+      emit(t);
+    } else if (t.IsIdent()) {
+      if (FindFunction(t.val()) < kMathFunctions.size())
+        tx[top++] = Token::Function(t.val());
+      else
+        variable(t.val());
+    } else if (t.IsOpenBrace()) {
+      tx[top++] = t;
+    } else if (t.IsCloseBrace()) {
+      while (top != 0 && tx[top - 1] != Token::OpenBrace()) emit(tx[--top]);
+      if (top == 0) throw std::invalid_argument("unbalanced ')'");
+      --top;
+      if (top != 0 && tx[top - 1].kind() == Token::Kind::Function)
+        emit(tx[--top]);
+    } else if (t.IsOperator()) {
+      handle_operator(t);
+    } else if (t != Token::Whitespace()) {
+      throw std::logic_error("invalid token");
+    }
+  }
+
+  while (top != 0) {
+    if (tx[top - 1] == Token::OpenBrace())
+      throw std::invalid_argument("unbalanced '('");
+    emit(tx[--top]);
+  }
+  if (depth == 0) throw std::invalid_argument("empty expression");
+  if (depth > 1) throw std::invalid_argument("missing operator");
+  prog.result = depth - 1;
+
+  return prog;
+}
+}  // namespace static_detail
+
+// Expression parsed and compiled during translation. The program is part of
+// the type, so Evaluate expands to straight-line code with no parsing,
+// dispatch or allocation at runtime:
+//
+//   static constexpr char kArea[] = "pi * r ^ 2";
+//   double a = s21::static_expr<kArea>::Evaluate(3.14159, 2.0);
+//
+// Arguments bind to variables in order of their first appearance.
+template <const char* Expr>
+class static_expr {
+ private:
+  static constexpr std::string_view kSource{Expr};
+  static constexpr auto kProgram =
+      static_detail::Compile<kSource.size() + 1>(kSource);
+
+ public:
+  static constexpr std::size_t arity = kProgram.vars;
+
+ public:
+  template <typename... Args>
+  static auto Evaluate(Args... args) -> double {
+    static_assert(sizeof...(Args) == arity,
+                  "argument count must match the expression's variables");
+
+    const double vars[] = {static_cast<double>(args)..., 0.0};
+    double stack[kProgram.depth]{};
+
+    Run_(stack, vars, std::make_index_sequence<kProgram.size>());
+
+    return stack[kProgram.result];
+  }
+
+  template <typename... Args>
+  auto operator()(Args... args) const -> double {
+    return Evaluate(args...);
+  }
+
+ private:
+  template <std::size_t... I>
+  static void Run_(double* stack, const double* vars,
+                   std::index_sequence<I...>) {
+    (Step_<I>(stack, vars), ...);
+  }
+
+  template <std::size_t I>
+  static void Step_(double* s, const double* vars) {
+    using Op = static_detail::Op;
+    constexpr auto in = kProgram.code[I];
+
+    if constexpr (in.op == Op::Number)
+      s[in.dst] = in.value;
+    else if constexpr (in.op == Op::Variable)
+      s[in.dst] = vars[in.var];
+    else if constexpr (in.op == Op::Add)
+      s[in.dst] = s[in.dst] + s[in.dst + 1];
+    else if constexpr (in.op == Op::Sub)
+      s[in.dst] = s[in.dst] - s[in.dst + 1];
+    else if constexpr (in.op == Op::Mul)
+      s[in.dst] = s[in.dst] * s[in.dst + 1];
+    else if constexpr (in.op == Op::Div)
+      s[in.dst] = s[in.dst] / s[in.dst + 1];
+    else if constexpr (in.op == Op::Mod)
+      s[in.dst] = std::fmod(s[in.dst], s[in.dst + 1]);
+    else if constexpr (in.op == Op::Pow)
+      s[in.dst] = std::pow(s[in.dst], s[in.dst + 1]);
+    else if constexpr (in.op == Op::Neg)
+      s[in.dst] = -s[in.dst];
+    else
+      s[in.dst] = kMathFunctions[in.fn].fn(s[in.dst]);
+  }
+};
+}  // namespace s21
+
+#endif  // SMART_CALC_V2_MODEL_STATIC_EXPR_H_
@@ -0,0 +1,30 @@
+#ifndef SMART_CALC_V2_TESTS_ALLOC_COUNTER_H_
+#define SMART_CALC_V2_TESTS_ALLOC_COUNTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new to count heap allocations. It defines
+// the replacement functions, so include it from exactly one translation
+// unit per binary.
+
+static std::atomic<std::size_t> allocations{0};
+
+// Optimized and sanitizer builds inline the replacement and flag
+// malloc/free as a mismatch with the builtin operator new.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#endif  // SMART_CALC_V2_TESTS_ALLOC_COUNTER_H_
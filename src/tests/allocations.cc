@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "model.h"
+#include "parser.h"
+
+using s21::SmartCalc;
+
+template <typename Fn>
+static auto CountAllocations(Fn fn) {
+  auto before = allocations.load();
+  fn();
+  return allocations.load() - before;
+}
+
+TEST(Allocations, CountsHeapUse) {
+  ASSERT_GT(CountAllocations([] { std::vector<double> v(16); }), 0);
+}
+
+TEST(Allocations, SteadyStateEvaluate) {
+  SmartCalc calc;
+  const char* exprs[] = {
+      "x",
+      "sin(x*12.5)-(cos(3.14)^10+tan(x))",
+      "((x+1)*(x-2)-(x*3)/(x+4))^2%7+sqrt(x*x)",
+  };
+
+  for (auto tier : {SmartCalc::Tier::Interpreter, SmartCalc::Tier::Jit}) {
+    for (auto src : exprs) {
+      auto expr = calc.Compile(src, tier);
+
+      auto count = CountAllocations([&] {
+        for (double x = -10; x < 10; x += 0.01) expr.Evaluate(x);
+      });
+
+      ASSERT_EQ(count, 0) << src;
+    }
+  }
+}
+
+TEST(Allocations, SteadyStateLargeFrame) {
+  SmartCalc calc;
+  std::string src = "x";
+
+  // Each distinct constant takes a register, well past the 64 that fit in
+  // the stack frame.
+  for (int i = 1; i <= 128; ++i)
+    src += " + " + std::to_string(i) + ".5";
+
+  for (auto tier : {SmartCalc::Tier::Interpreter, SmartCalc::Tier::Jit}) {
+    auto expr = calc.Compile(src, tier);
+    expr.Evaluate(1);
+
+    auto count = CountAllocations([&] {
+      for (double x = -10; x < 10; x += 0.01) expr.Evaluate(x);
+    });
+
+    ASSERT_EQ(count, 0);
+  }
+}
+
+TEST(Allocations, ParseReusesBuffers) {
+  const s21::FunctionRegistry functions;
+  const std::vector<std::string> vars{"x"};
+  auto src = "((x+1)*(x-2)-(x*3)/(x+4))^2%7+sqrt(x*x)+hypot(x, 3)";
+  s21::Arena arena;
+  s21::Parser parser(functions, vars, arena);
+
+  auto parse = [&] {
+    arena.Reset();
+    parser.Parse(src);
+  };
+
+  ASSERT_GT(CountAllocations(parse), 0);
+  ASSERT_EQ(CountAllocations(parse), 0);
+}
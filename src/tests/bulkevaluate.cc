@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "io/bulk.h"
+#include "io/mapped_file.h"
+
+using s21::io::kRecordWidth;
+
+static auto TempPath(const std::string& name) {
+  return testing::TempDir() + "smartcalc_" + name;
+}
+
+static void WriteFile(const std::string& path, const std::string& text) {
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+static auto ReadFile(const std::string& path) {
+  std::stringstream ss;
+  ss << std::ifstream(path, std::ios::binary).rdbuf();
+  return ss.str();
+}
+
+static auto Record(const std::string& text) {
+  return text + std::string(kRecordWidth - 1 - text.size(), ' ') + "\n";
+}
+
+TEST(Bulk, ParseLine) {
+  auto line = s21::io::ParseLine("  hypot(x, 3) , -4.5 ");
+  ASSERT_EQ(line.expr, "hypot(x, 3)");
+  ASSERT_EQ(line.x, -4.5);
+
+  line = s21::io::ParseLine("max(x, 1)");
+  ASSERT_EQ(line.expr, "max(x, 1)");
+  ASSERT_EQ(line.x, 0);
+
+  EXPECT_THROW(s21::io::ParseLine("x, 1e"), std::invalid_argument);
+  EXPECT_THROW(s21::io::ParseLine("x,"), std::invalid_argument);
+}
+
+TEST(Bulk, EvaluatesEveryLine) {
+  s21::SmartCalc calc;
+  auto input = TempPath("bulk_in.txt");
+  auto output = TempPath("bulk_out.txt");
+  WriteFile(input, "1 + 2\r\nx * 2, 4\n\nfoo\nhypot(x, 3),4");
+
+  auto expected = Record("3") + Record("8") + Record("") +
+                  Record("error: unknown variable 'foo'") + Record("5");
+
+  for (std::size_t threads : {1, 2, 16}) {
+    auto stats = s21::io::BulkEvaluate(calc, input, output, threads);
+    ASSERT_EQ(stats.lines, 5);
+    ASSERT_EQ(stats.errors, 1);
+    ASSERT_EQ(ReadFile(output), expected);
+  }
+}
+
+TEST(Bulk, SplitsAtNewlines) {
+  s21::SmartCalc calc;
+  auto input = TempPath("bulk_many.txt");
+  auto output = TempPath("bulk_many_out.txt");
+  std::string text, expected;
+
+  for (int i = 0; i < 1000; ++i) {
+    text += "x + " + std::to_string(i) + "," + std::to_string(i) + "\n";
+    expected += Record(std::to_string(2 * i));
+  }
+  WriteFile(input, text);
+
+  auto stats = s21::io::BulkEvaluate(calc, input, output, 7);
+  ASSERT_EQ(stats.lines, 1000);
+  ASSERT_EQ(ReadFile(output), expected);
+}
+
+TEST(Bulk, EmptyInput) {
+  auto input = TempPath("bulk_empty.txt");
+  auto output = TempPath("bulk_empty_out.txt");
+  WriteFile(input, "");
+
+  auto stats = s21::io::BulkEvaluate(s21::SmartCalc(), input, output, 4);
+  ASSERT_EQ(stats.lines, 0);
+  ASSERT_EQ(ReadFile(output), "");
+  EXPECT_THROW(s21::io::MappedFile::OpenRead(TempPath("missing")),
+               std::runtime_error);
+}
+
+TEST(Bulk, RefusesToOverwriteInput) {
+  auto input = TempPath("bulk_self.txt");
+  WriteFile(input, "1 + 2\n");
+
+  EXPECT_THROW(s21::io::BulkEvaluate(s21::SmartCalc(), input, input),
+               std::invalid_argument);
+  ASSERT_EQ(ReadFile(input), "1 + 2\n");
+  EXPECT_THROW(s21::io::BulkEvaluate(s21::SmartCalc(), input,
+                                     TempPath("bulk_self_out.txt"),
+                                     s21::io::kMaxThreads + 1),
+               std::invalid_argument);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "io/columns.h"
+
+using s21::io::ColumnFile;
+
+static auto TempPath(const std::string& name) {
+  return testing::TempDir() + "smartcalc_" + name;
+}
+
+TEST(ColumnFile, RoundTrip) {
+  auto path = TempPath("columns.bin");
+
+  {
+    auto file = ColumnFile::Create(path, {"x", "rate"}, 5);
+    for (std::size_t i = 0; i < 5; ++i) {
+      file.column(0)[i] = double(i);
+      file.column(1)[i] = 0.5 * i;
+    }
+  }
+
+  const auto file = ColumnFile::Open(path);
+  ASSERT_EQ(file.rows(), 5);
+  ASSERT_EQ(file.names(), (std::vector<std::string>{"x", "rate"}));
+
+  for (std::size_t c = 0; c < file.columns(); ++c) {
+    auto addr = reinterpret_cast<std::uintptr_t>(file.column(c));
+    ASSERT_EQ(addr % ColumnFile::kAlignment, 0);
+  }
+  ASSERT_EQ(file.column(0)[4], 4);
+  ASSERT_EQ(file.column(1)[3], 1.5);
+}
+
+TEST(ColumnFile, EvaluateColumns) {
+  auto input = TempPath("columns_in.bin");
+  auto output = TempPath("columns_out.bin");
+  constexpr std::size_t kRows = 1000;
+
+  {
+    auto file = ColumnFile::Create(input, {"a", "b"}, kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+      file.column(0)[i] = 0.01 * i;
+      file.column(1)[i] = 10 - 0.02 * i;
+    }
+  }
+
+  s21::SmartCalc calc;
+  ASSERT_EQ(s21::io::EvaluateColumns(calc, "hypot(a, b) - a", input, output),
+            kRows);
+
+  const auto in = ColumnFile::Open(input);
+  const auto out = ColumnFile::Open(output);
+  ASSERT_EQ(out.names(), (std::vector<std::string>{"y"}));
+  ASSERT_EQ(out.rows(), kRows);
+
+  for (std::size_t i = 0; i < kRows; ++i) {
+    auto a = in.column(0)[i], b = in.column(1)[i];
+    ASSERT_DOUBLE_EQ(out.column(0)[i], std::hypot(a, b) - a);
+  }
+
+  EXPECT_THROW(s21::io::EvaluateColumns(calc, "c", input, output),
+               std::logic_error);
+}
+
+TEST(ColumnFile, RefusesToOverwriteInput) {
+  auto path = TempPath("columns_self.bin");
+
+  {
+    auto file = ColumnFile::Create(path, {"x"}, 3);
+    for (std::size_t i = 0; i < 3; ++i) file.column(0)[i] = i + 1.0;
+  }
+
+  EXPECT_THROW(s21::io::EvaluateColumns(s21::SmartCalc(), "x * 2", path, path),
+               std::invalid_argument);
+
+  const auto file = ColumnFile::Open(path);
+  ASSERT_EQ(file.names(), (std::vector<std::string>{"x"}));
+  for (std::size_t i = 0; i < 3; ++i) ASSERT_EQ(file.column(0)[i], i + 1.0);
+}
+
+TEST(ColumnFile, RejectsInvalidFiles) {
+  auto path = TempPath("columns_bad.bin");
+
+  std::ofstream(path, std::ios::binary) << "SCALCCOL but not really";
+  EXPECT_THROW(ColumnFile::Open(path), std::runtime_error);
+
+  ColumnFile::Create(path, {"x"}, 100);
+  std::filebuf buf;
+  buf.open(path, std::ios::in | std::ios::out | std::ios::binary);
+  buf.pubseekpos(16);
+  buf.sputn("\xff\xff\xff\xff", 4);
+  buf.close();
+  EXPECT_THROW(ColumnFile::Open(path), std::runtime_error);
+
+  EXPECT_THROW(ColumnFile::Create(path, {""}, 1), std::invalid_argument);
+  ColumnFile::Create(path, {"x"}, 1);
+  auto file = ColumnFile::Open(path);
+  EXPECT_THROW(file.column(0), std::logic_error);
+}
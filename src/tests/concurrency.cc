@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "controller/controller.h"
+
+using s21::SmartCalc;
+
+constexpr int kThreads = 8;
+
+template <typename Body>
+static void RunThreads(Body body) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) threads.emplace_back(body, t);
+  for (auto& thread : threads) thread.join();
+}
+
+TEST(Concurrency, SharedSmartCalcCompiles) {
+  const SmartCalc calc;
+  std::atomic<int> failures{0};
+
+  RunThreads([&](int t) {
+    for (int i = 0; i < 200; ++i) {
+      auto expr = "hypot(x, " + std::to_string(t) + ") + " + std::to_string(i);
+      if (calc.Evaluate(expr, 1) != std::hypot(1, t) + i) ++failures;
+    }
+  });
+
+  ASSERT_EQ(failures, 0);
+}
+
+TEST(Concurrency, SharedCompiledExpression) {
+  const SmartCalc calc;
+  std::atomic<int> failures{0};
+
+  for (auto tier : {SmartCalc::Tier::Interpreter, SmartCalc::Tier::Jit}) {
+    const auto expr = calc.Compile("(sin(x) * x) + clamp(x, -1, 1)", tier);
+
+    RunThreads([&](int t) {
+      std::vector<double> xs(300), out(xs.size());
+      for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = t + 0.01 * i;
+
+      expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+      for (std::size_t i = 0; i < xs.size(); ++i)
+        if (expr.Evaluate(xs[i]) != out[i]) ++failures;
+    });
+  }
+
+  ASSERT_EQ(failures, 0);
+}
+
+TEST(Concurrency, SharedController) {
+  s21::Controller ctrl(std::make_unique<SmartCalc>(),
+                       std::make_unique<s21::CreditCalc>(), 4);
+  std::atomic<int> failures{0};
+
+  RunThreads([&](int t) {
+    for (int i = 0; i < 500; ++i) {
+      auto expr = "x * " + std::to_string((t + i) % 6);
+      if (ctrl.Eval(expr, 2) != 2 * ((t + i) % 6)) ++failures;
+    }
+  });
+
+  auto stats = ctrl.GetCacheStats();
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(stats.hits + stats.misses, kThreads * 500);
+}
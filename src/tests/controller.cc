@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller/controller.h"
+
+static auto MakeController(std::size_t capacity) {
+  return s21::Controller(std::make_unique<s21::SmartCalc>(),
+                         std::make_unique<s21::CreditCalc>(), capacity);
+}
+
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+  s21::LruCache<int> cache(2);
+  int made = 0;
+  auto make = [&made] { return ++made; };
+
+  ASSERT_EQ(cache.GetOrInsert("a", make), 1);
+  ASSERT_EQ(cache.GetOrInsert("b", make), 2);
+  ASSERT_EQ(cache.GetOrInsert("a", make), 1);
+  ASSERT_EQ(cache.GetOrInsert("c", make), 3);
+  ASSERT_EQ(cache.GetOrInsert("a", make), 1);
+  ASSERT_EQ(cache.GetOrInsert("b", make), 4);
+
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.stats().hits, 2);
+  ASSERT_EQ(cache.stats().misses, 4);
+  ASSERT_EQ(cache.stats().evictions, 2);
+
+  cache.SetCapacity(1);
+  ASSERT_EQ(cache.size(), 1);
+  ASSERT_EQ(cache.stats().evictions, 3);
+  ASSERT_EQ(cache.GetOrInsert("b", make), 4);
+}
+
+TEST(LruCache, FailedInsertIsNotCached) {
+  s21::LruCache<int> cache(4);
+
+  EXPECT_THROW(cache.GetOrInsert("a", []() -> int { throw 1; }), int);
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.GetOrInsert("a", [] { return 7; }), 7);
+}
+
+TEST(LruCache, FirstInsertWins) {
+  s21::LruCache<int> cache(4);
+
+  ASSERT_EQ(cache.Find("a"), nullptr);
+  ASSERT_EQ(cache.Find("a"), nullptr);
+  ASSERT_EQ(cache.Insert("a", 1), 1);
+  ASSERT_EQ(cache.Insert("a", 2), 1);
+  ASSERT_EQ(*cache.Find("a"), 1);
+
+  ASSERT_EQ(cache.size(), 1);
+  ASSERT_EQ(cache.stats().hits, 1);
+  ASSERT_EQ(cache.stats().misses, 2);
+}
+
+TEST(Controller, CachesCompiledExpressions) {
+  auto ctrl = MakeController(8);
+
+  for (int i = 0; i < 10; ++i) ASSERT_DOUBLE_EQ(ctrl.Eval("x * 2", i), 2 * i);
+
+  std::vector<double> xs{1, 2, 3}, out(xs.size());
+  ctrl.EvalBatch("x * 2", xs.data(), out.data(), xs.size());
+  ASSERT_EQ(out, (std::vector<double>{2, 4, 6}));
+
+  ASSERT_EQ(ctrl.GetCacheStats().misses, 1);
+  ASSERT_EQ(ctrl.GetCacheStats().hits, 10);
+  EXPECT_THROW(ctrl.Eval("x +", 1), std::invalid_argument);
+  ASSERT_EQ(ctrl.GetCacheStats().misses, 2);
+}
+
+TEST(Controller, BoundedCache) {
+  auto ctrl = MakeController(4);
+
+  for (int i = 0; i < 100; ++i) {
+    auto expr = "x + " + std::to_string(i % 8);
+    ASSERT_DOUBLE_EQ(ctrl.Eval(expr, 1), 1 + i % 8);
+  }
+
+  ASSERT_EQ(ctrl.GetCacheStats().misses, 100);
+  ASSERT_EQ(ctrl.GetCacheStats().evictions, 96);
+
+  ctrl.SetCacheCapacity(0);
+  ASSERT_DOUBLE_EQ(ctrl.Eval("x + 1", 1), 2);
+  ASSERT_EQ(ctrl.GetCacheStats().misses, 101);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "model.h"
+
+using s21::Interval;
+using s21::SmartCalc;
+
+static double Cube(double x) { return x * x * x; }
+
+// Every defined point result for x sampled across the range must fall
+// inside the bounds.
+static void ExpectEncloses(const SmartCalc& calc, const char* src,
+                           Interval x) {
+  auto expr = calc.Compile(src);
+  auto bounds = expr.EvaluateInterval(x);
+
+  for (int i = 0; i <= 1000; ++i) {
+    double point = i == 1000 ? x.hi : x.lo + (x.hi - x.lo) * (i / 1000.0);
+    double value = expr.Evaluate(point);
+
+    if (std::isnan(value)) continue;
+
+    ASSERT_TRUE(bounds.Contains(value))
+        << src << " at x = " << point << ": " << value << " not in ["
+        << bounds.lo << ", " << bounds.hi << "]";
+  }
+}
+
+TEST(IntervalArithmetic, EnclosesPointResults) {
+  SmartCalc calc;
+  const char* exprs[] = {
+      "x + 0.1",      "0.1 - x",         "x * x - 3 * x",  "1 / (x + 5)",
+      "x % 0.7",      "-x % 3",          "x ^ 2",          "x ^ 3",
+      "x ^ -2",       "2 ^ x",           "x ^ 0.5",        "-x",
+      "sin(x)",       "cos(3 * x)",      "tan(x / 4)",     "asin(x / 2)",
+      "acos(x / 3)",  "atan(x)",         "sqrt(x)",        "ln(x)",
+      "log(x + 3)",   "pow(x, 2.5)",     "atan2(x, 2)",    "atan2(1, x)",
+      "hypot(x, 1)",  "min(x, 0.5)",     "max(x, -x)",     "clamp(x, -1, 1)",
+      "sin(x) * cos(x) + sqrt(hypot(x, 2)) / (2 + x ^ 2)",
+  };
+
+  for (auto src : exprs)
+    for (auto x : {Interval{-2, 2}, Interval{0.25, 0.75}, Interval{-7, -1},
+                   Interval{1, 1}, Interval{-100, 300}})
+      ExpectEncloses(calc, src, x);
+}
+
+// Ranges with infinite or coinciding ends, checked at the points of a
+// fixed grid that fall inside them.
+TEST(IntervalArithmetic, EnclosesAtInfiniteAndDegenerateEnds) {
+  SmartCalc calc;
+  const char* exprs[] = {
+      "x * 0",        "0 * (1 / x)", "x * x",       "x / x",
+      "1 / x",        "x / (x + 1)", "x - x",       "x + x",
+      "-x * 2 ^ x",   "x % 3",       "x ^ 2",       "2 ^ x",
+      "sqrt(x) * 0",  "sin(x) * x",  "atan(x) / x", "hypot(x, x)",
+      "min(x, 0) * x", "max(x, 1) / x",
+  };
+  const double points[] = {-INFINITY, -1e300, -3, -1, -0.5, 0,
+                           0.5,       1,      3,  1e300, INFINITY};
+  const Interval ranges[] = {Interval::Entire(), {0, INFINITY},
+                             {-INFINITY, 0},     {0, 0},
+                             {-0.5, -0.5},       {INFINITY, INFINITY},
+                             {1, INFINITY}};
+
+  for (auto src : exprs) {
+    auto expr = calc.Compile(src);
+
+    for (auto x : ranges) {
+      auto bounds = expr.EvaluateInterval(x);
+
+      for (double point : points) {
+        if (!x.Contains(point)) continue;
+        double value = expr.Evaluate(point);
+        if (std::isnan(value)) continue;
+
+        ASSERT_TRUE(bounds.Contains(value))
+            << src << " at x = " << point << " in [" << x.lo << ", "
+            << x.hi << "]: " << value << " not in [" << bounds.lo << ", "
+            << bounds.hi << "]";
+      }
+    }
+  }
+
+  ASSERT_TRUE(calc.EvaluateInterval("0 * (1 / x)", {-1, 1}).Contains(0));
+  ASSERT_TRUE(calc.EvaluateInterval("x * 0", Interval::Entire()).Contains(0));
+}
+
+TEST(IntervalArithmetic, TightForMonotoneExpressions) {
+  SmartCalc calc;
+  auto bounds = calc.EvaluateInterval("2 * x + 1", {1, 3});
+
+  ASSERT_LE(bounds.lo, 3);
+  ASSERT_GE(bounds.hi, 7);
+  ASSERT_NEAR(bounds.lo, 3, 1e-12);
+  ASSERT_NEAR(bounds.hi, 7, 1e-12);
+
+  bounds = calc.EvaluateInterval("sin(x)", {0, 4});
+  ASSERT_EQ(bounds.hi, 1);
+  ASSERT_NEAR(bounds.lo, std::sin(4), 1e-12);
+  ASSERT_EQ(calc.EvaluateInterval("x ^ 2", {-3, 2}).lo, 0);
+  ASSERT_EQ(calc.EvaluateInterval("cos(x)", {-10, 10}), (Interval{-1, 1}));
+}
+
+TEST(IntervalArithmetic, DomainsAndPoles) {
+  SmartCalc calc;
+
+  ASSERT_TRUE(calc.EvaluateInterval("sqrt(x)", {-3, -1}).IsEmpty());
+  ASSERT_TRUE(calc.EvaluateInterval("asin(x)", {2, 3}).IsEmpty());
+  ASSERT_TRUE(calc.EvaluateInterval("sqrt(x) + 1", {-3, -1}).IsEmpty());
+  ASSERT_NEAR(calc.EvaluateInterval("sqrt(x)", {-3, 4}).hi, 2, 1e-12);
+  ASSERT_EQ(calc.EvaluateInterval("1 / x", {-1, 1}), Interval::Entire());
+  ASSERT_EQ(calc.EvaluateInterval("tan(x)", {1, 2}), Interval::Entire());
+  ASSERT_EQ(calc.EvaluateInterval("min(sqrt(x), 2)", {-3, -1}),
+            Interval::Point(2));
+}
+
+TEST(IntervalArithmetic, Variables) {
+  SmartCalc calc;
+  auto expr = calc.Compile("a * b - c", {"a", "b", "c"});
+  const Interval values[] = {{1, 2}, {-1, 3}};
+  auto bounds = expr.EvaluateInterval(values, 2);
+
+  ASSERT_NEAR(bounds.lo, -2, 1e-12);
+  ASSERT_NEAR(bounds.hi, 6, 1e-12);
+  EXPECT_THROW(expr.EvaluateInterval({2, 1}), std::invalid_argument);
+
+  const Interval too_many[4] = {};
+  EXPECT_THROW(expr.EvaluateInterval(too_many, 4), std::invalid_argument);
+}
+
+TEST(IntervalArithmetic, UserFunctions) {
+  SmartCalc calc;
+  calc.RegisterFunction("cube", Cube);
+
+  ASSERT_EQ(calc.EvaluateInterval("cube(x)", {1, 2}), Interval::Entire());
+
+  calc.RegisterInterval("cube", [](const Interval* args) {
+    return Interval{Cube(args[0].lo), Cube(args[0].hi)};
+  });
+  ASSERT_EQ(calc.EvaluateInterval("cube(x) + 0", {1, 2}).hi,
+            std::nextafter(8.0, INFINITY));
+  EXPECT_THROW(calc.RegisterInterval("quartic", nullptr),
+               std::invalid_argument);
+
+  calc.RegisterFunction("sin", Cube);
+  ASSERT_EQ(calc.EvaluateInterval("sin(x)", {1, 2}), Interval::Entire());
+}
+
+TEST(IntervalArithmetic, NativeExpression) {
+  SmartCalc calc;
+  auto expr = calc.Compile("x * x + 1", SmartCalc::Tier::Jit);
+  auto bounds = expr.EvaluateInterval({-1, 2});
+
+  ASSERT_LE(bounds.lo, 1);
+  ASSERT_GE(bounds.hi, 5);
+}
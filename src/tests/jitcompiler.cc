@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "model.h"
+
+using s21::SmartCalc;
+using Tier = s21::SmartCalc::Tier;
+
+static void ExpectSameBits(double lhs, double rhs) {
+  ASSERT_EQ(std::memcmp(&lhs, &rhs, sizeof(double)), 0) << lhs << " " << rhs;
+}
+
+TEST(Jit, MatchesInterpreter) {
+  SmartCalc calc;
+  const char* exprs[] = {
+      "x",
+      "2.5",
+      "-x",
+      "x + 1 - 2 * x / 3",
+      "x % 0.7 + x ^ 3",
+      "sin(x) * cos(x) + tan(x) - atan(x)",
+      "sqrt(x * x + 1) + ln(x * x + 2) + log(x * x + 3)",
+      "asin(x / 10) + acos(x / 10)",
+      "-(-cos(3.14) ^ 10 + tan(x))",
+      "(sin(x)*sin(x))+(sin(x)*((x+1)/(x+1)))",
+      "1 / x",
+      "hypot(x, 3) + atan2(x, 2) - min(x, 1 / x)",
+      "clamp(x, -1, 2 * x) * max(sin(x), pow(x, 2))",
+  };
+
+  for (auto expr : exprs) {
+    auto native = calc.Compile(expr, Tier::Jit);
+
+    for (double x = -5; x <= 5; x += 0.25)
+      ExpectSameBits(native.Evaluate(x), calc.Evaluate(expr, x));
+  }
+}
+
+TEST(Jit, Batch) {
+  SmartCalc calc;
+  constexpr auto expr = "sin(x*12.5)-(cos(3.14)^10+tan(x))";
+  auto native = calc.Compile(expr, Tier::Jit);
+  std::vector<double> xs(1000), out(xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = -5 + 0.01 * i;
+  native.EvaluateBatch(xs.data(), out.data(), xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i)
+    ExpectSameBits(out[i], calc.Evaluate(expr, xs[i]));
+}
+
+TEST(Jit, SignedZeroAndSpecials) {
+  SmartCalc calc;
+  auto native = calc.Compile("-x / x", Tier::Jit);
+
+  ExpectSameBits(native.Evaluate(0), calc.Evaluate("-x / x", 0));
+  ExpectSameBits(native.Evaluate(INFINITY), calc.Evaluate("-x / x", INFINITY));
+  ExpectSameBits(calc.Compile("-x", Tier::Jit).Evaluate(0), -0.0);
+}
+
+TEST(Jit, CopiesShareCode) {
+  SmartCalc calc;
+  s21::CompiledExpression copy;
+
+  {
+    auto native = calc.Compile("x * 2 + 1", Tier::Jit);
+    copy = native;
+  }
+
+  ASSERT_DOUBLE_EQ(copy.Evaluate(3), 7);
+}
+
+static auto Checked(double x) -> double {
+  if (x > 0) throw std::domain_error("positive argument");
+  return x;
+}
+
+TEST(Jit, RegisteredFunctionsMayThrow) {
+  SmartCalc calc;
+  calc.RegisterFunction("checked", Checked);
+  auto expr = calc.Compile("sin(checked(x)) + 1", Tier::Jit);
+  const double xs[] = {-1, 1};
+  double out[2];
+
+  ASSERT_FALSE(expr.IsNative());
+  ASSERT_DOUBLE_EQ(expr.Evaluate(-1), std::sin(-1.0) + 1);
+  EXPECT_THROW(expr.Evaluate(1), std::domain_error);
+  EXPECT_THROW(expr.EvaluateBatch(xs, out, 2), std::domain_error);
+}
+
+#if defined(__x86_64__) && !defined(_WIN32)
+TEST(Jit, Native) {
+  SmartCalc calc;
+  ASSERT_TRUE(calc.Compile("x + 1", Tier::Jit).IsNative());
+  ASSERT_TRUE(calc.Compile("clamp(hypot(x, 1), 0, 5)", Tier::Jit).IsNative());
+  ASSERT_FALSE(calc.Compile("x + 1").IsNative());
+
+  calc.RegisterFunction("sin", [](double x) { return x; });
+  ASSERT_FALSE(calc.Compile("sin(x)", Tier::Jit).IsNative());
+}
+#endif
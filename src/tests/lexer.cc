@@ -138,3 +138,52 @@ TEST(Lexer, Collect) {
 
   for (auto& t : lexer.Collect()) ASSERT_EQ(t, *(expect_it++));
 }
+
+static auto Lex(std::string_view expr) {
+  std::vector<Token> tokens;
+  s21::Lexer lexer(expr);
+  for (auto tok = lexer.Next(); tok != Token::EndStream(); tok = lexer.Next())
+    tokens.push_back(tok);
+  return tokens;
+}
+
+TEST(Lexer, LongRuns) {
+  std::string spaces(37, ' '), digits(41, '7'), ident(35, 'q');
+  spaces[20] = '\t';
+  ident[33] = '9';
+
+  auto expr = spaces + digits + "." + digits + "." + spaces + ident + "Z(" +
+              spaces + "\n" + digits + ")";
+  auto tokens = Lex(expr);
+
+  ASSERT_EQ(tokens.size(), 6);
+  ASSERT_EQ(tokens[0], Token::Number(digits + "." + digits));
+  ASSERT_EQ(tokens[1], Token::Invalid("."));
+  ASSERT_EQ(tokens[2], Token::Ident(ident + "Z"));
+  ASSERT_EQ(tokens[3], Token::OpenBrace());
+  ASSERT_EQ(tokens[4], Token::Number(digits));
+  ASSERT_EQ(tokens[5], Token::CloseBrace());
+}
+
+TEST(Lexer, RunBoundaries) {
+  for (std::size_t n = 1; n < 40; ++n) {
+    std::string digits(n, '3'), ident(n, 'k');
+    auto expr = digits + "+" + ident + std::string(n, ' ') + "-1\x80";
+    auto tokens = Lex(expr);
+
+    ASSERT_EQ(tokens.size(), 6) << n;
+    ASSERT_EQ(tokens[0], Token::Number(digits));
+    ASSERT_EQ(tokens[2], Token::Ident(ident));
+    ASSERT_EQ(tokens[3], Token::MinusOp());
+    ASSERT_EQ(tokens[4], Token::Number("1"));
+    ASSERT_EQ(tokens[5], Token::Invalid("\x80"));
+  }
+}
+
+static constexpr auto LexedAtCompileTime() {
+  s21::Lexer lexer("    12345678901234567890.5  abcdefghijklmnopqrstu ");
+  lexer.Next();
+  return lexer.Next();
+}
+
+static_assert(LexedAtCompileTime() == Token::Ident("abcdefghijklmnopqrstu"));
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "controller/controller.h"
+#include "parallel.h"
+
+using s21::ParallelExecutor;
+using s21::SmartCalc;
+
+static auto Tabulate(std::size_t n) {
+  std::vector<double> xs(n);
+  for (std::size_t i = 0; i < n; ++i) xs[i] = -50 + 0.001 * i;
+  return xs;
+}
+
+TEST(ParallelExecutor, MatchesSerialBatch) {
+  SmartCalc calc;
+  auto expr = calc.Compile("(sin(x) * x) - hypot(x, 2) % 3");
+  auto xs = Tabulate(5 * ParallelExecutor::kChunk + 123);
+  std::vector<double> serial(xs.size()), out(xs.size());
+
+  expr.EvaluateBatch(xs.data(), serial.data(), xs.size());
+
+  for (std::size_t threads : {1, 3, 8}) {
+    ParallelExecutor executor(threads);
+    std::fill(out.begin(), out.end(), 0);
+
+    auto report = executor.Run(expr, xs.data(), out.data(), xs.size());
+    ASSERT_EQ(out, serial);
+    ASSERT_EQ(executor.size(), threads);
+    ASSERT_EQ(report.threads.size(), threads);
+
+    std::size_t values = 0, chunks = 0;
+    for (auto& thread : report.threads) {
+      values += thread.values;
+      chunks += thread.chunks;
+    }
+    ASSERT_EQ(values, xs.size());
+    ASSERT_EQ(chunks, 6);
+  }
+}
+
+static auto Checked(double x) -> double {
+  if (x > 0) throw std::domain_error("positive argument");
+  return x;
+}
+
+TEST(ParallelExecutor, RethrowsFromWorkers) {
+  SmartCalc calc;
+  calc.RegisterFunction("checked", Checked);
+  auto expr = calc.Compile("checked(x)");
+  auto xs = Tabulate(8 * ParallelExecutor::kChunk);
+  std::vector<double> out(xs.size());
+  ParallelExecutor executor(4);
+
+  EXPECT_THROW(executor.Run(expr, xs.data(), out.data(), xs.size()),
+               std::domain_error);
+
+  std::size_t valid = std::count_if(xs.begin(), xs.end(),
+                                    [](double x) { return x <= 0; });
+  executor.Run(expr, xs.data(), out.data(), valid);
+  ASSERT_TRUE(std::equal(out.begin(), out.begin() + valid, xs.begin()));
+}
+
+TEST(ParallelExecutor, ReusedAcrossRuns) {
+  SmartCalc calc;
+  ParallelExecutor executor(4);
+
+  for (auto src : {"x + 1", "x * 2", "-x"}) {
+    auto expr = calc.Compile(src);
+    auto xs = Tabulate(ParallelExecutor::kChunk * 2);
+    std::vector<double> serial(xs.size()), par(xs.size());
+
+    expr.EvaluateBatch(xs.data(), serial.data(), xs.size());
+    executor.Run(expr, xs.data(), par.data(), xs.size());
+    ASSERT_EQ(par, serial);
+  }
+
+  auto report = executor.Run(calc.Compile("x"), nullptr, nullptr, 0);
+  ASSERT_EQ(report.Throughput(), 0);
+}
+
+TEST(Controller, EvalParallel) {
+  s21::Controller ctrl(std::make_unique<SmartCalc>(),
+                       std::make_unique<s21::CreditCalc>());
+  auto xs = Tabulate(100000);
+  std::vector<double> out(xs.size());
+
+  auto report = ctrl.EvalParallel("x * x", xs.data(), out.data(), xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i)
+    ASSERT_DOUBLE_EQ(out[i], xs[i] * xs[i]);
+  ASSERT_GE(report.threads.size(), 1);
+}
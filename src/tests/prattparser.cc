@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "model.h"
+#include "parser.h"
+
+using s21::AstNode;
+using s21::Token;
+
+// Prints the tree fully parenthesised, e.g. "(1 + (2 * x))".
+static auto Show(const AstNode* node) -> std::string {
+  std::stringstream ss;
+
+  switch (node->kind) {
+    case Token::Kind::Number:
+      ss << node->value;
+      break;
+    case Token::Kind::Variable:
+      ss << "v" << node->slot;
+      break;
+    case Token::Kind::Negate:
+      ss << "-" << Show(node->args[0]);
+      break;
+    case Token::Kind::Function:
+      ss << node->fn->name << "(";
+      for (std::uint32_t i = 0; i < node->arity; ++i)
+        ss << (i ? ", " : "") << Show(node->args[i]);
+      ss << ")";
+      break;
+    default:
+      ss << "(" << Show(node->args[0]) << " " << Token(node->kind).c_str()
+         << " " << Show(node->args[1]) << ")";
+      break;
+  }
+
+  return ss.str();
+}
+
+class PrattParser : public ::testing::Test {
+ protected:
+  auto Parse(std::string_view expr) -> std::string {
+    return Show(s21::Parser(functions_, vars_, arena_).Parse(expr));
+  }
+
+  s21::FunctionRegistry functions_;
+  std::vector<std::string> vars_{"x", "y"};
+  s21::Arena arena_;
+};
+
+TEST_F(PrattParser, BindingOrder) {
+  ASSERT_EQ(Parse("1 + 2 * x"), "(1 PlusOp (2 MulOp v0))");
+  ASSERT_EQ(Parse("1 - 2 - y"), "((1 MinusOp 2) MinusOp v1)");
+  ASSERT_EQ(Parse("x * 2 ^ 3"), "(v0 MulOp (2 ExpOp 3))");
+  ASSERT_EQ(Parse("2 ^ 3 ^ x"), "((2 ExpOp 3) ExpOp v0)");
+  ASSERT_EQ(Parse("-x ^ 2"), "(-v0 ExpOp 2)");
+  ASSERT_EQ(Parse("(1 + x) % 2"), "((1 PlusOp v0) ModOp 2)");
+}
+
+TEST_F(PrattParser, Calls) {
+  ASSERT_EQ(Parse("clamp(x, -1, 1 + y)"), "clamp(v0, -1, (1 PlusOp v1))");
+  ASSERT_EQ(Parse("-sin(x) ^ 2"), "(-sin(v0) ExpOp 2)");
+  EXPECT_THROW(Parse("hypot(x)"), std::invalid_argument);
+  EXPECT_THROW(Parse("z + 1"), std::logic_error);
+}
+
+TEST_F(PrattParser, CountsTokens) {
+  s21::Parser parser(functions_, vars_, arena_);
+  parser.Parse("hypot(x, +1) - 2");
+  ASSERT_EQ(parser.tokens(), 9);
+}
+
+TEST(Arena, ReusesBlocks) {
+  s21::Arena arena;
+
+  for (int round = 0; round < 3; ++round) {
+    arena.Reset();
+    for (std::size_t i = 0; i < 3 * s21::Arena::kBlockSize / sizeof(AstNode);
+         ++i)
+      ASSERT_NE(arena.New(AstNode{}), nullptr);
+  }
+
+  ASSERT_LE(arena.capacity(), 4 * s21::Arena::kBlockSize);
+}
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <clocale>
 #include <cmath>
+#include <cstring>
+#include <string>
 #include <vector>
 
+#include "decimal.h"
 #include "model.h"
 
 using s21::SmartCalc;
@@ -153,3 +157,450 @@ TEST(SmartCalc, ComplexExpressionXX) {
   ASSERT_DOUBLE_EQ(calc.Evaluate("sin(x*12.5)-(cos(3.14)^10+tan(x))", x),
                    expected);
 }
+
+TEST(SmartCalc, CompileOnce) {
+  SmartCalc calc;
+  auto expr = calc.Compile("sin(x*12.5)-(cos(3.14)^10+tan(x))");
+
+  for (double x = -1; x < 1; x += 0.125)
+    ASSERT_DOUBLE_EQ(expr.Evaluate(x),
+                     calc.Evaluate("sin(x*12.5)-(cos(3.14)^10+tan(x))", x));
+}
+
+TEST(SmartCalc, CompiledOutlivesSource) {
+  SmartCalc calc;
+  s21::CompiledExpression expr;
+
+  {
+    std::string src = "2.5 * x + 1";
+    expr = calc.Compile(src);
+    src.assign(src.size(), '9');
+  }
+
+  ASSERT_DOUBLE_EQ(expr.Evaluate(2), 6);
+}
+
+TEST(SmartCalc, CompileInvalidIdent) {
+  SmartCalc calc;
+  EXPECT_THROW(calc.Compile("y + 1"), std::logic_error);
+}
+
+TEST(SmartCalc, EvaluateBatch) {
+  SmartCalc calc;
+  constexpr auto expr = "-(-cos(x) ^ 2 + tan(x)) * x % 3";
+  std::vector<double> xs(1000), out(xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i) xs[i] = -5 + 0.01 * i;
+  calc.EvaluateBatch(expr, xs.data(), out.data(), xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i)
+    ASSERT_DOUBLE_EQ(out[i], calc.Evaluate(expr, xs[i]));
+}
+
+TEST(SmartCalc, EvaluateBatchEmpty) {
+  SmartCalc calc;
+  double out = 42;
+  calc.EvaluateBatch("x + 1", nullptr, &out, 0);
+  ASSERT_DOUBLE_EQ(out, 42);
+}
+
+TEST(SmartCalc, DefaultCompiledExpression) {
+  s21::CompiledExpression expr;
+  std::vector<double> xs{1, 2, 3}, out(xs.size(), 42);
+
+  ASSERT_EQ(expr.arity(), 0);
+  ASSERT_EQ(expr.Evaluate(), 0);
+  ASSERT_EQ(expr.Evaluate(nullptr, 0), 0);
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+  ASSERT_EQ(out, std::vector<double>(xs.size(), 0));
+  ASSERT_EQ(expr.EvaluateInterval({-1, 1}), s21::Interval::Point(0));
+}
+
+TEST(SmartCalc, StackUnderflow) {
+  SmartCalc calc;
+  EXPECT_THROW(calc.Compile("1 +"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("-"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("sin()"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile(""), std::invalid_argument);
+}
+
+TEST(SmartCalc, Precedence) {
+  SmartCalc calc;
+  ASSERT_DOUBLE_EQ(calc.Evaluate("1 + 2 * 3"), 7);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("2 * 3 + 1"), 7);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("10 - 4 - 3"), 3);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("64 / 4 / 2"), 8);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("2 * 3 ^ 2"), 18);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("2 ^ 3 ^ 2"), 64);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("-2 ^ 2"), 4);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("2 ^ -1 * 4"), 2);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("7 % 4 * 2"), 6);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("1 - -x", 2), 3);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("(+2)"), 2);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("1 - 2 * 3 - 4 + 2 ^ 3 ^ 2 % 7.5"), -5);
+}
+
+TEST(SmartCalc, MalformedExpressions) {
+  SmartCalc calc;
+  EXPECT_THROW(calc.Compile("(1 + 2"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("1 + 2)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("2 x"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("2 (x)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("sin x"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("hypot(x,,1)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("1 * * 2"), std::invalid_argument);
+
+  auto deep = std::string(2000, '(') + "x" + std::string(2000, ')');
+  EXPECT_THROW(calc.Compile(deep), std::invalid_argument);
+  ASSERT_DOUBLE_EQ(calc.Evaluate(deep.substr(1000, 2001), 3), 3);
+}
+
+TEST(SmartCalc, LongChains) {
+  SmartCalc calc;
+  std::string sum = "x";
+  for (int i = 0; i < 100000; ++i) sum += "+1";
+
+  ASSERT_DOUBLE_EQ(calc.Evaluate(sum, 0.5), 100000.5);
+}
+
+TEST(SmartCalc, EvaluateBatchPackedOps) {
+  SmartCalc calc;
+  auto expr = calc.Compile("-x * 3 / (x - 0.5) + -x");
+  std::vector<double> xs{0, -0.0, 0.5, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  std::vector<double> out(xs.size());
+
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    auto expected = expr.Evaluate(xs[i]);
+    ASSERT_EQ(std::signbit(out[i]), std::signbit(expected));
+    if (expected == expected) {
+      ASSERT_EQ(out[i], expected);
+    }
+  }
+}
+
+TEST(SmartCalc, RegisterReuse) {
+  SmartCalc calc;
+  auto expr = calc.Compile("((x+1)*(x-2)-(x*3)/(x+4))^2%7+sqrt(x*x)");
+
+  for (double x = -3; x < 3; x += 0.25) {
+    double expected =
+        fmod(pow((x + 1) * (x - 2) - (x * 3) / (x + 4), 2), 7) + sqrt(x * x);
+    ASSERT_DOUBLE_EQ(expr.Evaluate(x), expected);
+  }
+}
+
+TEST(SmartCalc, EvaluateBatchOperandOnly) {
+  SmartCalc calc;
+  std::vector<double> xs{1, 2, 3}, out(xs.size());
+
+  calc.EvaluateBatch("x", xs.data(), out.data(), xs.size());
+  ASSERT_EQ(out, xs);
+
+  calc.EvaluateBatch("2.5", xs.data(), out.data(), xs.size());
+  ASSERT_EQ(out, std::vector<double>(xs.size(), 2.5));
+}
+
+TEST(SmartCalc, ConstantFolding) {
+  SmartCalc calc;
+  auto expr = calc.Compile("sqrt(2)*3.1415926/180*x");
+
+  for (double x = -2; x < 2; x += 0.5)
+    ASSERT_EQ(expr.Evaluate(x), sqrt(2) * 3.1415926 / 180 * x);
+}
+
+TEST(SmartCalc, ConstantFoldingIeee) {
+  SmartCalc calc;
+
+  ASSERT_EQ(calc.Evaluate("x + 1 / 0", 1), INFINITY);
+  ASSERT_EQ(calc.Evaluate("x - -1 / 0", 1), INFINITY);
+  ASSERT_TRUE(std::isnan(calc.Evaluate("x * (0 / 0)", 1)));
+  ASSERT_TRUE(std::isnan(calc.Evaluate("sqrt(-1) + x", 1)));
+  ASSERT_TRUE(std::signbit(calc.Evaluate("-0")));
+  ASSERT_TRUE(std::signbit(calc.Evaluate("x * -(0)", 1)));
+}
+
+TEST(ExprDag, HashConsing) {
+  using Kind = s21::Token::Kind;
+  s21::ExprDag dag;
+
+  s21::FunctionRegistry functions;
+  auto sin = functions.Find("sin");
+  auto cos = functions.Find("cos");
+
+  auto x = dag.Add({Kind::Variable});
+  auto sin_x = dag.Add({Kind::Function, {x}, sin});
+
+  ASSERT_EQ(dag.Add({Kind::Variable}), x);
+  ASSERT_EQ(dag.Add({Kind::Function, {x}, sin}), sin_x);
+  ASSERT_NE(dag.Add({Kind::Function, {x}, cos}), sin_x);
+  ASSERT_NE(dag.Add({Kind::Number, {}, nullptr, 0.0}),
+            dag.Add({Kind::Number, {}, nullptr, -0.0}));
+  ASSERT_EQ(dag.size(), 5);
+}
+
+TEST(SmartCalc, CommonSubexpressions) {
+  SmartCalc calc;
+  auto expr = calc.Compile("(sin(x)*sin(x))+(sin(x)*((x+1)/(x+1)))");
+  std::vector<double> xs{-1.5, -0.5, 0.25, 1, 2}, out(xs.size());
+
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    double x = xs[i];
+    double expected = sin(x) * sin(x) + sin(x) * ((x + 1) / (x + 1));
+    ASSERT_DOUBLE_EQ(expr.Evaluate(x), expected);
+    ASSERT_DOUBLE_EQ(out[i], expected);
+  }
+}
+
+TEST(SmartCalc, LiteralBoundedByToken) {
+  SmartCalc calc;
+  ASSERT_DOUBLE_EQ(calc.Evaluate(std::string_view("1234", 2)), 12);
+  ASSERT_DOUBLE_EQ(calc.Evaluate(std::string_view("x*2.5", 4), 2), 4);
+}
+
+TEST(SmartCalc, LiteralPrecision) {
+  SmartCalc calc;
+  ASSERT_EQ(calc.Evaluate("0.1"), 0.1);
+  ASSERT_EQ(calc.Evaluate("3.141592653589793238"), 3.141592653589793238);
+  ASSERT_EQ(calc.Evaluate("123456789012345678901234567890"),
+            123456789012345678901234567890.0);
+}
+
+TEST(SmartCalc, LiteralOutOfRange) {
+  SmartCalc calc;
+  ASSERT_EQ(calc.Evaluate(std::string(400, '9')), INFINITY);
+  ASSERT_EQ(calc.Evaluate("0." + std::string(400, '0') + "1"), 0);
+}
+
+TEST(SmartCalc, LiteralIgnoresLocale) {
+  auto prev = std::string(std::setlocale(LC_NUMERIC, nullptr));
+  if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") == nullptr)
+    GTEST_SKIP() << "de_DE.UTF-8 locale is not available";
+
+  SmartCalc calc;
+  auto result = calc.Evaluate("1.25");
+  std::setlocale(LC_NUMERIC, prev.c_str());
+
+  ASSERT_DOUBLE_EQ(result, 1.25);
+}
+
+TEST(SmartCalc, DecimalConversions) {
+  auto parse = [](const char* text, double& value) {
+    return s21::decimal::FromChars(text, text + std::strlen(text), value);
+  };
+  double value = 0;
+
+  ASSERT_EQ(parse("0.1", value).ec, std::errc());
+  ASSERT_EQ(value, 0.1);
+  const char* trailing = "-2.5e-3x";
+  ASSERT_EQ(parse(trailing, value).ptr, trailing + 7);
+  ASSERT_EQ(value, -2.5e-3);
+  ASSERT_EQ(parse("1e400", value).ec, std::errc::result_out_of_range);
+  ASSERT_EQ(value, -2.5e-3);
+
+  for (auto text : {"", "+1", " 1", "-", "e5"})
+    ASSERT_EQ(parse(text, value).ec, std::errc::invalid_argument) << text;
+
+  const char* hex = "0x10";
+  ASSERT_EQ(parse(hex, value).ptr, hex + 1);
+  ASSERT_EQ(value, 0);
+
+  char digits[32];
+  for (double x : {0.1, 3.0, -1e-5, 1e100, 123456789.125, 1.0 / 3}) {
+    auto [end, ec] = s21::decimal::ToChars(digits, digits + 32, x);
+    ASSERT_EQ(ec, std::errc());
+    ASSERT_EQ(parse(std::string(digits, end).c_str(), value).ec, std::errc());
+    ASSERT_EQ(value, x);
+  }
+
+  auto [end, ec] = s21::decimal::ToChars(digits, digits + 32, 0.1);
+  ASSERT_EQ(std::string(digits, end), "0.1");
+  ASSERT_EQ(s21::decimal::ToChars(digits, digits + 2, 1.0 / 3).ec,
+            std::errc::value_too_large);
+}
+
+static double Cube(double x) { return x * x * x; }
+
+static void CubeBatch(const double* in, double* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) out[i] = -in[i] * in[i] * in[i];
+}
+
+static double Sum3(const double* args) { return args[0] + args[1] + args[2]; }
+
+TEST(FunctionRegistry, Builtins) {
+  s21::FunctionRegistry functions;
+
+  ASSERT_EQ(functions.size(), s21::kMathFunctions.size() + 6);
+  ASSERT_EQ(functions.Find("sin")->arity, 1);
+  ASSERT_EQ(functions.Find("hypot")->arity, 2);
+  ASSERT_EQ(functions.Find("clamp")->arity, 3);
+  ASSERT_EQ(functions.Find("ln")->fn,
+            static_cast<s21::SmartCalc::MathFn>(log10));
+  ASSERT_EQ(functions.Find("cube"), nullptr);
+}
+
+TEST(FunctionRegistry, InvalidNames) {
+  s21::FunctionRegistry functions;
+
+  EXPECT_THROW(functions.Register("x", Cube), std::invalid_argument);
+  EXPECT_THROW(functions.Register("", Cube), std::invalid_argument);
+  EXPECT_THROW(functions.Register("2pi", Cube), std::invalid_argument);
+  EXPECT_THROW(functions.Register("cu be", Cube), std::invalid_argument);
+  EXPECT_THROW(functions.Register("cube", s21::FunctionRegistry::MathFn{}),
+               std::invalid_argument);
+  EXPECT_THROW(functions.Register("wide", 9, Sum3), std::invalid_argument);
+}
+
+TEST(SmartCalc, RegisterFunction) {
+  SmartCalc calc;
+
+  EXPECT_THROW(calc.Compile("cube(x)"), std::logic_error);
+
+  calc.RegisterFunction("cube", Cube);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("cube(x) + cube(2)", 3), 35);
+
+  calc.RegisterFunction("sin", Cube);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("sin(x)", 2), 8);
+}
+
+TEST(SmartCalc, RegisterBatchFunction) {
+  SmartCalc calc;
+  std::vector<double> xs{1, 2, 3}, out(xs.size());
+
+  // The batch variant deliberately differs to show which path ran.
+  calc.RegisterFunction("cube", Cube, CubeBatch);
+  auto expr = calc.Compile("cube(x)");
+
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+  ASSERT_EQ(out, (std::vector<double>{-1, -8, -27}));
+  ASSERT_DOUBLE_EQ(expr.Evaluate(2), 8);
+}
+
+TEST(SmartCalc, MultiArgumentFunctions) {
+  SmartCalc calc;
+
+  ASSERT_DOUBLE_EQ(calc.Evaluate("hypot(x, 4)", 3), 5);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("atan2(1, x)", -1), std::atan2(1, -1));
+  ASSERT_DOUBLE_EQ(calc.Evaluate("pow(x, 3)", 2), 8);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("min(x, -x)", 2), -2);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("max(x, -x)", 2), 2);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("clamp(x, -1, 1)", 5), 1);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("clamp(x, -1, 1)", -0.5), -0.5);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("max(min(x, 2), (1 + 1) * 3)", 7), 6);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("hypot(sin(x), cos(x))", 0.3), 1);
+  ASSERT_DOUBLE_EQ(calc.Evaluate("-max(1, +2)"), -2);
+}
+
+TEST(SmartCalc, FunctionArity) {
+  SmartCalc calc;
+
+  EXPECT_THROW(calc.Compile("hypot(x)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("hypot(x, 1, 2)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("sin(x, 1)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("clamp(x, 1)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("(x, 1)"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("x, 1"), std::invalid_argument);
+  EXPECT_THROW(calc.Compile(",x"), std::logic_error);
+}
+
+TEST(SmartCalc, RegisterNaryFunction) {
+  SmartCalc calc;
+  std::vector<double> xs{-1, 0, 2.5}, out(xs.size());
+
+  calc.RegisterFunction("sum", 3, Sum3);
+  auto expr = calc.Compile("sum(x, 2 * x, sum(1, 2, 3)) + x");
+
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    ASSERT_DOUBLE_EQ(out[i], 4 * xs[i] + 6);
+    ASSERT_DOUBLE_EQ(expr.Evaluate(xs[i]), out[i]);
+  }
+}
+
+TEST(SmartCalc, MultiArgumentConstantFolding) {
+  SmartCalc calc;
+  calc.RegisterFunction("sum", 3, Sum3);
+
+  for (auto src : {"hypot(3, 4)", "min(5, 1 + 4)", "sum(1, 2, 2)"}) {
+    auto expr = calc.Compile(src);
+    ASSERT_DOUBLE_EQ(expr.Evaluate(), 5);
+  }
+}
+
+TEST(SmartCalc, NamedVariables) {
+  SmartCalc calc;
+  auto expr = calc.Compile("(rate * (1 + growth) ^ years) - (fee / rate)",
+                           {"rate", "growth", "years", "fee"});
+  const double values[] = {2, 0.5, 3, 1};
+
+  ASSERT_EQ(expr.arity(), 4);
+  ASSERT_DOUBLE_EQ(expr.Evaluate(values, 4), 2 * std::pow(1.5, 3) - 0.5);
+  ASSERT_DOUBLE_EQ(expr.Evaluate(values, 3), 2 * std::pow(1.5, 3));
+  ASSERT_DOUBLE_EQ(expr.Evaluate(2), 2);
+  EXPECT_THROW(expr.Evaluate(values, 5), std::invalid_argument);
+}
+
+TEST(SmartCalc, NamedVariablesBatch) {
+  SmartCalc calc;
+  std::vector<double> a(600), b(a.size()), out(a.size());
+
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    a[i] = 0.01 * i;
+    b[i] = 3 - 0.02 * i;
+  }
+
+  for (auto tier : {SmartCalc::Tier::Interpreter, SmartCalc::Tier::Jit}) {
+    auto expr = calc.Compile("hypot(a, b) * a - b", {"b", "a"}, tier);
+    const double* columns[] = {b.data(), a.data()};
+
+    expr.EvaluateBatch(columns, 2, out.data(), out.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      const double values[] = {b[i], a[i]};
+      ASSERT_DOUBLE_EQ(out[i], expr.Evaluate(values, 2));
+      ASSERT_DOUBLE_EQ(out[i], std::hypot(a[i], b[i]) * a[i] - b[i]);
+    }
+  }
+}
+
+TEST(SmartCalc, InvalidVariables) {
+  SmartCalc calc;
+
+  EXPECT_THROW(calc.Compile("a + b", {"a"}), std::logic_error);
+  EXPECT_THROW(calc.Compile("a", {"a", "a"}), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("sin", {"sin"}), std::invalid_argument);
+  EXPECT_THROW(calc.Compile("a", {"a b"}), std::invalid_argument);
+  ASSERT_DOUBLE_EQ(calc.Compile("2 + 3", {}).Evaluate(7), 5);
+}
+
+TEST(SmartCalc, Stats) {
+  SmartCalc calc;
+  std::vector<double> xs(10), out(xs.size());
+
+  SmartCalc::ResetStats();
+  auto expr = calc.Compile("(1 + (2 * (3 - x))) / 4");
+  expr.Evaluate(1);
+  expr.EvaluateBatch(xs.data(), out.data(), xs.size());
+  auto stats = SmartCalc::Stats();
+
+  if constexpr (SmartCalc::kStatsEnabled) {
+    ASSERT_EQ(stats.lex.calls, 1);
+    ASSERT_EQ(stats.parse.calls, 1);
+    ASSERT_EQ(stats.compile.calls, 1);
+    ASSERT_EQ(stats.evaluate.calls, 2);
+    ASSERT_EQ(stats.tokens, 15);
+    ASSERT_EQ(stats.values, 11);
+    ASSERT_EQ(stats.max_frame, 6);
+    ASSERT_GT(stats.lex.nanoseconds, 0);
+    ASSERT_GT(stats.parse.nanoseconds, 0);
+
+    SmartCalc::ResetStats();
+    stats = SmartCalc::Stats();
+  }
+
+  ASSERT_EQ(stats.parse.calls, 0);
+  ASSERT_EQ(stats.values, 0);
+  ASSERT_EQ(stats.max_frame, 0);
+}
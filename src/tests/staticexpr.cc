@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "model.h"
+#include "static_expr.h"
+
+using s21::SmartCalc;
+using s21::static_expr;
+
+static constexpr char kComplex[] = "sin(x*12.5)-(cos(3.14)^10+tan(x))";
+static constexpr char kNegated[] = "-(-cos(3.14) ^ 10 + tan(x))";
+static constexpr char kPrecedence[] = "1-2*3-4 + 2^3^2 % 7.5";
+static constexpr char kNumber[] = "0.1";
+static constexpr char kAnnuity[] = "p * (r / (1 - (1 + r) ^ -n))";
+
+TEST(StaticExpr, Arity) {
+  static_assert(static_expr<kComplex>::arity == 1);
+  static_assert(static_expr<kNumber>::arity == 0);
+  static_assert(static_expr<kAnnuity>::arity == 3);
+}
+
+TEST(StaticExpr, MatchesSmartCalc) {
+  SmartCalc calc;
+
+  for (double x = -2; x <= 2; x += 0.125) {
+    ASSERT_EQ(static_expr<kComplex>::Evaluate(x), calc.Evaluate(kComplex, x));
+    ASSERT_EQ(static_expr<kNegated>::Evaluate(x), calc.Evaluate(kNegated, x));
+  }
+
+  ASSERT_EQ(static_expr<kPrecedence>::Evaluate(), -5);
+  ASSERT_EQ(static_expr<kPrecedence>::Evaluate(), calc.Evaluate(kPrecedence));
+  ASSERT_EQ(static_expr<kNumber>::Evaluate(), 0.1);
+}
+
+TEST(StaticExpr, MultipleVariables) {
+  double p = 300000, r = 7.5 / 1200, n = 12;
+  static_expr<kAnnuity> annuity;
+
+  ASSERT_EQ(annuity(p, r, n), p * (r / (1 - pow(1 + r, -n))));
+}
+
+TEST(StaticExpr, ExactLiterals) {
+  using s21::static_detail::ParseNumber;
+
+  static_assert(ParseNumber("9007199254740991") == 9007199254740991.0);
+  static_assert(ParseNumber("0.0000000000000000000001") == 1e-22);
+  ASSERT_EQ(ParseNumber("3.1415926535897"), 3.1415926535897);
+  EXPECT_THROW(ParseNumber("9007199254740993"), std::invalid_argument);
+  EXPECT_THROW(ParseNumber("0.00000000000000000000001"),
+               std::invalid_argument);
+  EXPECT_THROW(ParseNumber("3.14159265358979323846"), std::invalid_argument);
+}
@@ -12,15 +12,17 @@ void PlotGraph::Construct(const std::unique_ptr<s21::Controller> &ctrl,
                           double xmax, double ymax, const QString &input) {
   QPen pen;
   QVector<double> x_vec, y_vec;
+  std::vector<double> xs, ys;
 
-  double x = -xmax;
-  while (x < xmax) {
-    double y = ctrl->Eval(input.toStdString().c_str(), x);
-    if (fabs(y) < ymax) {
-      x_vec.push_back(x);
-      y_vec.push_back(y);
+  for (double x = -xmax; x < xmax; x += 0.1) xs.push_back(x);
+  ys.resize(xs.size());
+  ctrl->EvalBatch(input.toStdString(), xs.data(), ys.data(), xs.size());
+
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    if (fabs(ys[i]) < ymax) {
+      x_vec.push_back(xs[i]);
+      y_vec.push_back(ys[i]);
     }
-    x += 0.1;
   }
 
   pen.setColor(QColor(52, 237, 148));